@@ -0,0 +1,300 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+#include <vector>
+
+#include "fractals.h"
+#include "thread_pool.h"
+
+// Asynchronous renders for services holding many requests at once: a render
+// returns a RenderTask at once and runs as tiles on the shared pool, the task
+// completes when the last tile is done. Tasks are awaitable (co_await) from
+// coroutines returning RenderTask, or waited for with get(). Cancellation is
+// cooperative, checked before each tile: a cancelled or abandoned render
+// frees the pool within one tile. Needs C++20 (-std=c++20)
+
+// side of the square tiles a render is split into, the granularity of its
+// cancellation
+const int async_tile = 32;
+
+class RenderCancelled : public std::runtime_error {
+  // thrown by get() and co_await for a render cancelled before its end
+public:
+  RenderCancelled() : std::runtime_error("render cancelled") {}
+};
+
+template <typename T> class RenderTask {
+  /*
+    handle of an asynchronous render giving a T: copies share the render, and
+    when the last one is destroyed the render is cancelled (abandoned), unless
+    it already finished
+    the result is handed to every waiter: the coroutines awaiting any copy
+    of the task and the threads blocked in get()
+  */
+public:
+  struct State {
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+    std::optional<T> value;
+    std::exception_ptr error;
+    std::vector<std::coroutine_handle<>> waiters; // to resume when done
+    std::stop_source stop;
+
+    void complete(std::optional<T> result, std::exception_ptr failure) {
+      /*
+        stores the result and resumes the coroutines awaiting it, in the
+        order they started waiting, on the calling thread: the worker that
+        finished the render
+      */
+      std::vector<std::coroutine_handle<>> next;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        value = std::move(result);
+        error = failure;
+        done = true;
+        next.swap(waiters);
+      }
+      finished.notify_all();
+      for (std::coroutine_handle<> &waiter : next) {
+        waiter.resume();
+      }
+    }
+  };
+
+  struct Awaiter {
+    std::shared_ptr<State> state;
+
+    bool await_ready() const {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      return state->done;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) const {
+      // false resumes the coroutine at once, the render finished meanwhile
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->done) {
+        return false;
+      }
+      state->waiters.push_back(handle);
+      return true;
+    }
+
+    T await_resume() const {
+      if (state->error) {
+        std::rethrow_exception(state->error);
+      }
+      return *state->value;
+    }
+  };
+
+  struct CancelTask {
+    // stop callback cancelling an awaited task with the task awaiting it
+    std::stop_source stop;
+    void operator()() { stop.request_stop(); }
+  };
+
+  template <typename U> struct LinkedAwaiter {
+    typename RenderTask<U>::Awaiter awaiter;
+    std::stop_callback<CancelTask> link;
+
+    LinkedAwaiter(const RenderTask<U> &task, const std::stop_token &token)
+        : awaiter{task.state}, link(token, CancelTask{task.state->stop}) {}
+
+    bool await_ready() const { return awaiter.await_ready(); }
+    bool await_suspend(std::coroutine_handle<> handle) const {
+      return awaiter.await_suspend(handle);
+    }
+    U await_resume() const { return awaiter.await_resume(); }
+  };
+
+  struct promise_type {
+    /*
+      a coroutine returning RenderTask runs at once until its first co_await
+      of an unfinished task, then on the worker that finishes it; cancelling
+      the coroutine cancels the task it awaits
+    */
+    std::shared_ptr<State> state = std::make_shared<State>();
+
+    RenderTask get_return_object() { return RenderTask(state); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_value(T result) {
+      state->complete(std::move(result), nullptr);
+    }
+    void unhandled_exception() {
+      state->complete(std::nullopt, std::current_exception());
+    }
+
+    template <typename U>
+    LinkedAwaiter<U> await_transform(const RenderTask<U> &task) {
+      return LinkedAwaiter<U>(task, state->stop.get_token());
+    }
+  };
+
+  explicit RenderTask(std::shared_ptr<State> state)
+      : state(state), owner(std::make_shared<Abandon>(state->stop)) {}
+
+  Awaiter operator co_await() const { return {state}; }
+
+  bool done() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->done;
+  }
+
+  void cancel() const { state->stop.request_stop(); }
+
+  std::stop_token token() const { return state->stop.get_token(); }
+
+  T get() const {
+    /*
+      blocks until the render is over and returns its result, throws
+      RenderCancelled if it was cancelled; never to be called from a job of
+      the shared pool, whose workers may be the ones it waits for
+    */
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [this] { return state->done; });
+    if (state->error) {
+      std::rethrow_exception(state->error);
+    }
+    return *state->value;
+  }
+
+private:
+  template <typename> friend class RenderTask;
+
+  struct Abandon {
+    // cancels the render when the last handle of the task goes
+    std::stop_source stop;
+    ~Abandon() { stop.request_stop(); }
+  };
+
+  std::shared_ptr<State> state;
+  std::shared_ptr<Abandon> owner;
+};
+
+template <typename Job>
+RenderTask<decltype(std::declval<Job>()())> submit_async(Job job) {
+  /*
+    runs job on the shared pool as a single tile: it is skipped if the task
+    is cancelled before it starts
+  */
+  using Result = decltype(job());
+  auto state = std::make_shared<typename RenderTask<Result>::State>();
+  RenderTask<Result> task(state);
+  shared_pool().submit([state, job] {
+    if (state->stop.stop_requested()) {
+      state->complete(std::nullopt,
+                      std::make_exception_ptr(RenderCancelled()));
+      return;
+    }
+    try {
+      state->complete(job(), nullptr);
+    } catch (...) {
+      state->complete(std::nullopt, std::current_exception());
+    }
+  });
+  return task;
+}
+
+template <typename Fill>
+RenderTask<std::vector<double>> render_tiles_async(const int &dim,
+                                                   const int &tile, Fill fill) {
+  /*
+    renders a dim x dim board as tile x tile tiles on the shared pool, each
+    checking the cancellation before it starts
+    fill: fill(board, x_first, x_last, y_first, y_last) renders a tile
+  */
+  using Board = std::vector<double>;
+  auto state = std::make_shared<RenderTask<Board>::State>();
+  RenderTask<Board> task(state);
+  const int tiles_per_side = (dim + tile - 1) / tile;
+  auto board = std::make_shared<Board>(dim * dim, 1.0);
+  auto remaining = std::make_shared<std::atomic<int>>(tiles_per_side *
+                                                      tiles_per_side);
+  for (int tile_y = 0; tile_y < tiles_per_side; ++tile_y) {
+    for (int tile_x = 0; tile_x < tiles_per_side; ++tile_x) {
+      shared_pool().submit([=] {
+        if (!state->stop.stop_requested()) {
+          fill(*board, tile_x * tile, std::min(dim, (tile_x + 1) * tile),
+               tile_y * tile, std::min(dim, (tile_y + 1) * tile));
+        }
+        // the last tile to finish completes the task
+        if (remaining->fetch_sub(1) == 1) {
+          if (state->stop.stop_requested()) {
+            state->complete(std::nullopt,
+                            std::make_exception_ptr(RenderCancelled()));
+          } else {
+            state->complete(std::move(*board), nullptr);
+          }
+        }
+      });
+    }
+  }
+  return task;
+}
+
+RenderTask<std::vector<double>> render_async(const Viewport &frame,
+                                             const int &dim,
+                                             const int &tile = async_tile) {
+  /*
+    renders the dim x dim board of a viewport (see Fractals::fill_rectangle)
+    in tiles (see render_tiles_async); the board is the one of fill_board
+  */
+  return render_tiles_async(
+      dim, tile,
+      [frame, dim](std::vector<double> &board, const int &x_first,
+                   const int &x_last, const int &y_first, const int &y_last) {
+        Fractals::fill_rectangle(board, dim, frame, x_first, x_last, y_first,
+                                 y_last);
+      });
+}
+
+RenderTask<std::vector<double>>
+mandelbrot_async(const Mandelbrot &mandelbrot, const double &scaling_factor,
+                 const double &center_real, const double &center_im,
+                 const int &tile = async_tile) {
+  /*
+    same board as mandelbrot.mandelbrot_board, rendered asynchronously in
+    tiles, in double-double for frames closer than double_spacing
+  */
+  const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+  const int dim = mandelbrot.getDimension();
+  if (bounds.real() < double_spacing) {
+    const DoubleDouble corner_real =
+        two_sum(center_real, -2.0 * scaling_factor);
+    const DoubleDouble corner_im = two_sum(center_im, -1.13 * scaling_factor);
+    return render_tiles_async(
+        dim, tile,
+        [=](std::vector<double> &board, const int &x_first, const int &x_last,
+            const int &y_first, const int &y_last) {
+          Fractals::fill_rectangle(board, dim, bounds.real(), bounds.imag(),
+                                   corner_real, corner_im, 0.0, true,
+                                   board_max_iterations, x_first, x_last,
+                                   y_first, y_last);
+        });
+  }
+  return render_async({bounds.real(), bounds.imag(),
+                       center_real - 2.0 * scaling_factor,
+                       center_im - 1.13 * scaling_factor},
+                      dim, tile);
+}
+
+RenderTask<std::vector<double>> julia_async(const Julia &julia,
+                                            const std::complex<double> &c,
+                                            const int &tile = async_tile) {
+  // same board as julia.julia_board(c), rendered asynchronously in tiles
+  const double bound = 4.0 / (julia.getDimension() - 1);
+  return render_async({bound, bound, -2.0, -2.0, c, false,
+                       classify_julia(c).check_periodicity},
+                      julia.getDimension(), tile);
+}
@@ -0,0 +1,1357 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "fixedpoint.h"
+#include "thread_pool.h"
+
+// Deep zooms of the mandelbrot set by perturbation: one reference orbit is
+// computed in high precision, every pixel is iterated in double as a small
+// difference (delta) from it:
+//   z = Z + dz, c = C + dc -> dz = 2 * Z * dz + dz**2 + dc
+// dz and dc stay small numbers that double represents at any zoom depth, so
+// the frame keeps its detail long after the pixel coordinates themselves stop
+// being representable in double (around scaling factors of 1e-13)
+
+struct ReferenceOrbit {
+  // orbit of the reference point of a perturbation render
+  std::complex<double> offset; // reference point minus the center of the zoom
+  std::complex<double> c;      // reference point rounded to double
+  std::vector<std::complex<double>> z; // z[n] after n iterations, z[0] = 0
+  // offset and the dc of the pixels are in units of 2**scale_exponent, not 0
+  // only for frames past the range of double (see rescaled_iterations)
+  int scale_exponent = 0;
+  // not 0 for the orbit of a nucleus, z[n + period] = z[n] (see
+  // nucleus_reference_orbit)
+  int period = 0;
+};
+
+// continues a reference orbit from its last point up to a number of
+// iterations, keeping the point in the precision it is computed in
+using OrbitExtender = std::function<void(ReferenceOrbit &, const int &)>;
+
+template <typename Real>
+bool reference_step(Real &z_real, Real &z_im, const Real &c_real,
+                    const Real &c_im) {
+  // z = z**2 + c, false leaving z as it is if z escaped
+  const Real z_real2 = z_real * z_real;
+  const Real z_im2 = z_im * z_im;
+  if (z_real2 + z_im2 >= 4) {
+    return false;
+  }
+  z_im = 2 * z_real * z_im + c_im;
+  z_real = z_real2 - z_im2 + c_real;
+  return true;
+}
+
+template <int Limbs>
+bool reference_step(FixedPoint<Limbs> &z_real, FixedPoint<Limbs> &z_im,
+                    const FixedPoint<Limbs> &c_real,
+                    const FixedPoint<Limbs> &c_im) {
+  return fixed_step(z_real, z_im, c_real, c_im);
+}
+
+template <typename Real>
+OrbitExtender start_orbit(ReferenceOrbit &orbit, const Real &c_real,
+                          const Real &c_im, const Real &start_real = Real(0),
+                          const Real &start_im = Real(0)) {
+  /*
+    starts the orbit of c_real + i c_im at z[0] = start, 0 for the
+    mandelbrot set and the point of the plane for julia sets
+    returns what extends it, holding the last point in Real: extending an
+    orbit by n iterations costs n iterations, however long it already is
+  */
+  orbit.c = std::complex<double>(static_cast<double>(c_real),
+                                 static_cast<double>(c_im));
+  orbit.z.assign(1, std::complex<double>(static_cast<double>(start_real),
+                                         static_cast<double>(start_im)));
+  return [c_real, c_im, z_real = start_real, z_im = start_im](
+             ReferenceOrbit &orbit, const int &max_iter) mutable {
+    orbit.z.reserve(max_iter + 1);
+    while (static_cast<int>(orbit.z.size()) <= max_iter &&
+           reference_step(z_real, z_im, c_real, c_im)) {
+      orbit.z.emplace_back(static_cast<double>(z_real),
+                           static_cast<double>(z_im));
+    }
+  };
+}
+
+template <typename Real>
+ReferenceOrbit reference_orbit(const double &center_real,
+                               const double &center_im,
+                               const std::complex<double> &offset,
+                               const int &max_iter) {
+  /*
+    computes the orbit of c = center + offset with z = z**2 + c using the Real
+    type, then rounds it to double
+    center_real, center_im: center of the zoom
+    offset: where the reference point is with respect to the center
+    max_iter: length of the orbit, less if the reference point escapes
+
+    the orbit is only as good as Real: every frame needs Real to resolve its
+    pixels, that is precision well below the pixel spacing
+  */
+  ReferenceOrbit orbit;
+  orbit.offset = offset;
+  start_orbit(orbit, Real(center_real) + Real(offset.real()),
+              Real(center_im) + Real(offset.imag()))(orbit, max_iter);
+  return orbit;
+}
+
+template <int Limbs>
+OrbitExtender start_fixed_orbit(ReferenceOrbit &orbit,
+                                const double &center_real,
+                                const double &center_im,
+                                const std::complex<double> &offset,
+                                const int &scale_exponent,
+                                const std::complex<double> *julia_c = nullptr) {
+  /*
+    start_orbit in fixed point: the reference point center + offset is exact
+    as long as the last limb resolves offset
+    scale_exponent: offset is in units of 2**scale_exponent
+    julia_c: if not nullptr, the reference point is the start of an orbit
+    of the julia set of julia_c instead of the c of the mandelbrot set
+  */
+  orbit.offset = offset;
+  orbit.scale_exponent = scale_exponent;
+  const FixedPoint<Limbs> point_real =
+      FixedPoint<Limbs>(center_real) +
+      FixedPoint<Limbs>(offset.real(), scale_exponent);
+  const FixedPoint<Limbs> point_im =
+      FixedPoint<Limbs>(center_im) +
+      FixedPoint<Limbs>(offset.imag(), scale_exponent);
+  if (julia_c != nullptr) {
+    return start_orbit(orbit, FixedPoint<Limbs>(julia_c->real()),
+                       FixedPoint<Limbs>(julia_c->imag()), point_real,
+                       point_im);
+  }
+  return start_orbit(orbit, point_real, point_im);
+}
+
+template <int Limbs>
+ReferenceOrbit fixed_reference_orbit(const double &center_real,
+                                     const double &center_im,
+                                     const std::complex<double> &offset,
+                                     const int &max_iter,
+                                     const int &scale_exponent = 0) {
+  /*
+    same as reference_orbit<FixedPoint<Limbs>>, iterating with fixed_step
+    (see start_fixed_orbit)
+  */
+  ReferenceOrbit orbit;
+  start_fixed_orbit<Limbs>(orbit, center_real, center_im, offset,
+                           scale_exponent)(orbit, max_iter);
+  return orbit;
+}
+
+// pixel spacing below which the reference orbit leaves long double for fixed
+// point, and bits the fixed point keeps below the pixel spacing
+const double long_double_spacing = 1e-17;
+const int reference_guard_bits = 64;
+
+int reference_bits(const double &pixel_spacing, const int &scale_exponent) {
+  /*
+    bits below the binary point a reference orbit needs for the pixels of a
+    frame, 0 when long double is enough (see compute_reference_orbit)
+  */
+  if (pixel_spacing >= long_double_spacing && scale_exponent == 0) {
+    return 0;
+  }
+  return static_cast<int>(std::ceil(-std::log2(pixel_spacing))) -
+         scale_exponent + reference_guard_bits;
+}
+
+OrbitExtender start_reference_orbit(ReferenceOrbit &orbit,
+                                    const double &center_real,
+                                    const double &center_im,
+                                    const std::complex<double> &offset,
+                                    const int &bits,
+                                    const int &scale_exponent = 0,
+                                    const std::complex<double> *julia_c =
+                                        nullptr) {
+  /*
+    starts the reference orbit of center + offset in long double when bits
+    is 0, in fixed point otherwise, with the smallest number of limbs among
+    the ones instantiated that keeps bits (up to 2**-2016, about 1e-607)
+    scale_exponent: offset is in units of 2**scale_exponent
+    julia_c: if not nullptr, the orbit of center + offset in the julia set
+    of julia_c (see start_fixed_orbit)
+  */
+  if (bits == 0) {
+    orbit.offset = offset;
+    const long double point_real =
+        static_cast<long double>(center_real) + offset.real();
+    const long double point_im =
+        static_cast<long double>(center_im) + offset.imag();
+    if (julia_c != nullptr) {
+      return start_orbit<long double>(orbit, julia_c->real(), julia_c->imag(),
+                                      point_real, point_im);
+    }
+    return start_orbit(orbit, point_real, point_im);
+  }
+  if (bits <= 32 * 5) {
+    return start_fixed_orbit<6>(orbit, center_real, center_im, offset,
+                                scale_exponent, julia_c);
+  }
+  if (bits <= 32 * 7) {
+    return start_fixed_orbit<8>(orbit, center_real, center_im, offset,
+                                scale_exponent, julia_c);
+  }
+  if (bits <= 32 * 11) {
+    return start_fixed_orbit<12>(orbit, center_real, center_im, offset,
+                                 scale_exponent, julia_c);
+  }
+  if (bits <= 32 * 15) {
+    return start_fixed_orbit<16>(orbit, center_real, center_im, offset,
+                                 scale_exponent, julia_c);
+  }
+  if (bits <= 32 * 23) {
+    return start_fixed_orbit<24>(orbit, center_real, center_im, offset,
+                                 scale_exponent, julia_c);
+  }
+  if (bits <= 32 * 31) {
+    return start_fixed_orbit<32>(orbit, center_real, center_im, offset,
+                                 scale_exponent, julia_c);
+  }
+  if (bits <= 32 * 47) {
+    return start_fixed_orbit<48>(orbit, center_real, center_im, offset,
+                                 scale_exponent, julia_c);
+  }
+  return start_fixed_orbit<64>(orbit, center_real, center_im, offset,
+                               scale_exponent, julia_c);
+}
+
+ReferenceOrbit compute_reference_orbit(const double &center_real,
+                                       const double &center_im,
+                                       const std::complex<double> &offset,
+                                       const int &max_iter,
+                                       const double &pixel_spacing = 1.0,
+                                       const int &scale_exponent = 0) {
+  /*
+    reference orbit in the widest floating point type of the compiler (80
+    bits on x86, 64 bits of mantissa) for pixel spacings down to
+    long_double_spacing, in fixed point below: with reference_guard_bits
+    more than the pixel spacing needs (see reference_bits)
+    scale_exponent: offset and pixel_spacing are in units of
+    2**scale_exponent, for frames deeper than the range of double
+  */
+  ReferenceOrbit orbit;
+  start_reference_orbit(orbit, center_real, center_im, offset,
+                        reference_bits(pixel_spacing, scale_exponent),
+                        scale_exponent)(orbit, max_iter);
+  return orbit;
+}
+
+// Newton steps tried on the nucleus of a minibrot before giving up, and
+// relative size of the last one
+const int newton_steps = 64;
+const double newton_tolerance = 1e-15;
+
+struct Nucleus {
+  // center of a minibrot: z[period] = 0 for c = center + offset
+  int period = 0;              // 0 if no nucleus was found
+  std::complex<double> offset; // in units of 2**scale_exponent of the orbit
+};
+
+int ball_period(ReferenceOrbit &orbit, const OrbitExtender &extend,
+                const double &radius, const int &max_period) {
+  /*
+    lowest period of the minibrots around the reference point of orbit: the
+    disk of c of that radius is iterated as a ball around the orbit,
+      r[n + 1] = 2 |Z[n]| r[n] + r[n]**2 + radius
+    and the first n whose ball contains 0 is the period of a nucleus near it
+    (Robert Munafo's ball period method)
+    extend: extends orbit, that is only computed as far as the ball gets
+    radius: in units of 2**orbit.scale_exponent
+
+    returns 0 if no ball up to max_period contains 0, or if the orbit
+    escapes first
+  */
+  double ball = 0.0;
+  for (int n = 1; n <= max_period; ++n) {
+    if (static_cast<int>(orbit.z.size()) <= n) {
+      extend(orbit, n);
+      if (static_cast<int>(orbit.z.size()) <= n) {
+        return 0;
+      }
+    }
+    ball = 2.0 * std::abs(orbit.z[n - 1]) * ball +
+           std::ldexp(ball * ball, orbit.scale_exponent) + radius;
+    if (std::abs(orbit.z[n]) < std::ldexp(ball, orbit.scale_exponent)) {
+      return n;
+    }
+  }
+  return 0;
+}
+
+Nucleus newton_nucleus(const ReferenceOrbit &orbit, const int &period) {
+  /*
+    solves z[period](c) = 0 by Newton's method from the reference point of
+    orbit, iterating the offset of c from it by perturbation so that it is
+    as precise as the orbit however deep the zoom:
+      e[n + 1] = 2 Z[n] e[n] + e[n]**2 + offset, z[n] = Z[n] + e[n]
+      d[n + 1] = 2 z[n] d[n] + 1 (d = dz / dc)
+      offset = offset - z[period] / d[period]
+    orbit: at least period iterations long, offset and e in units of
+    2**orbit.scale_exponent
+
+    returns period 0 if Newton's method does not converge
+  */
+  const double scale = std::ldexp(1.0, orbit.scale_exponent);
+  std::complex<double> offset = 0.0;
+  for (int step = 0; step < newton_steps; ++step) {
+    std::complex<double> e = 0.0;
+    std::complex<double> d = 0.0;
+    for (int n = 0; n < period; ++n) {
+      d = 2.0 * (orbit.z[n] + scale * e) * d + 1.0;
+      e = 2.0 * orbit.z[n] * e + scale * e * e + offset;
+    }
+    const std::complex<double> z =
+        std::complex<double>(
+            std::ldexp(orbit.z[period].real(), -orbit.scale_exponent),
+            std::ldexp(orbit.z[period].imag(), -orbit.scale_exponent)) +
+        e;
+    const std::complex<double> change = z / d;
+    if (!std::isfinite(change.real()) || !std::isfinite(change.imag())) {
+      return {};
+    }
+    offset -= change;
+    if (std::abs(change) <= newton_tolerance * std::abs(offset)) {
+      return {period, offset};
+    }
+  }
+  return {};
+}
+
+Nucleus find_nucleus(ReferenceOrbit &orbit, const OrbitExtender &extend,
+                     const std::complex<double> &low,
+                     const std::complex<double> &high,
+                     const int &max_period) {
+  /*
+    nucleus of the minibrot of lowest period in the rectangle between low
+    and high (offsets from the reference point of orbit, in its units), found
+    by ball_period and newton_nucleus
+    extend: extends orbit as far as the period
+
+    returns period 0 if there is none up to max_period or it is out of the
+    rectangle
+  */
+  // the disk around the reference point holding the whole rectangle
+  const double radius = std::hypot(
+      std::max(std::abs(low.real()), std::abs(high.real())),
+      std::max(std::abs(low.imag()), std::abs(high.imag())));
+  const int period = ball_period(orbit, extend, radius, max_period);
+  if (period == 0) {
+    return {};
+  }
+  const Nucleus nucleus = newton_nucleus(orbit, period);
+  if (nucleus.period == 0 || nucleus.offset.real() < low.real() ||
+      nucleus.offset.real() > high.real() ||
+      nucleus.offset.imag() < low.imag() ||
+      nucleus.offset.imag() > high.imag()) {
+    return {};
+  }
+  return nucleus;
+}
+
+ReferenceOrbit nucleus_reference_orbit(const double &center_real,
+                                       const double &center_im,
+                                       const std::complex<double> &low,
+                                       const std::complex<double> &high,
+                                       const int &max_iter,
+                                       const double &pixel_spacing = 1.0,
+                                       const int &scale_exponent = 0) {
+  /*
+    reference orbit of the nucleus of lowest period of a frame, the
+    rectangle between center + low and center + high: the orbit of a
+    nucleus never escapes and comes back to 0 every period, so that fewer
+    pixels outlive or glitch against it than against the orbit of the
+    center. Only one period is computed in high precision, the rest repeats
+    it (the cycle of a nucleus is superattracting: rounding the nucleus does
+    not move its orbit away from it)
+    falls back to the orbit of the center when the frame has no nucleus of
+    period up to max_iter
+  */
+  const int bits = reference_bits(pixel_spacing, scale_exponent);
+  ReferenceOrbit center;
+  center.scale_exponent = scale_exponent;
+  const OrbitExtender extend_center = start_reference_orbit(
+      center, center_real, center_im, 0.0, bits, scale_exponent);
+  const Nucleus nucleus =
+      find_nucleus(center, extend_center, low, high, max_iter);
+  if (nucleus.period > 0) {
+    ReferenceOrbit orbit;
+    start_reference_orbit(orbit, center_real, center_im, nucleus.offset,
+                          bits, scale_exponent)(orbit, nucleus.period);
+    if (static_cast<int>(orbit.z.size()) == nucleus.period + 1) {
+      orbit.period = nucleus.period;
+      orbit.z.reserve(max_iter + 1);
+      for (int n = nucleus.period + 1; n <= max_iter; ++n) {
+        orbit.z.push_back(orbit.z[n - nucleus.period]);
+      }
+      return orbit;
+    }
+  }
+  extend_center(center, max_iter);
+  return center;
+}
+
+class ReferenceCache {
+  /*
+    orbit of the center of a zoom (or of a point near it, see set_reference),
+    shared read-only by every frame and every thread rendering toward it:
+    it is computed once at the precision of the
+    deepest frame that asks for it, extended when a frame needs more
+    iterations (the last point is kept in high precision, so only the new
+    iterations are computed) and recomputed only when a frame needs more
+    precision
+    filename: if not empty, the orbit is read from there when it was saved
+    for the same center and saved there whenever it changes, so that a
+    rerun of the same zoom does no high precision work (an orbit read from
+    disk can not be extended, it is recomputed if a frame needs more)
+  */
+private:
+  double center_real;
+  double center_im;
+  // reference point minus the center, in units of 2**offset_exponent
+  std::complex<double> offset = 0.0;
+  int offset_exponent = 0;
+  std::string filename;
+  std::mutex mutex;
+  std::shared_ptr<const ReferenceOrbit> shared;
+  int bits = -1;      // precision of shared (see reference_bits), -1 if none
+  int iterations = 0; // iterations asked so far, shared is shorter if escaped
+  OrbitExtender extend; // continues shared, empty if it was read from disk
+
+  static constexpr std::uint32_t file_tag = 0x4f524231; // "ORB1"
+
+  std::shared_ptr<const ReferenceOrbit>
+  scaled_orbit(const int &scale_exponent) const {
+    // shared, in the units of a frame
+    if (scale_exponent == shared->scale_exponent) {
+      return shared;
+    }
+    ReferenceOrbit scaled = *shared;
+    const int shift = shared->scale_exponent - scale_exponent;
+    scaled.offset = std::complex<double>(std::ldexp(offset.real(), shift),
+                                         std::ldexp(offset.imag(), shift));
+    scaled.scale_exponent = scale_exponent;
+    return std::make_shared<const ReferenceOrbit>(std::move(scaled));
+  }
+
+  void load() {
+    // leaves the cache empty unless filename holds an orbit of the center
+    std::ifstream file(filename, std::ios::binary);
+    std::uint32_t tag = 0;
+    double real = 0.0, im = 0.0;
+    std::complex<double> file_offset = 0.0;
+    std::int32_t file_exponent = 0, file_bits = 0, file_iterations = 0;
+    std::uint64_t length = 0;
+    file.read(reinterpret_cast<char *>(&tag), sizeof(tag));
+    file.read(reinterpret_cast<char *>(&real), sizeof(real));
+    file.read(reinterpret_cast<char *>(&im), sizeof(im));
+    file.read(reinterpret_cast<char *>(&file_offset), sizeof(file_offset));
+    file.read(reinterpret_cast<char *>(&file_exponent),
+              sizeof(file_exponent));
+    file.read(reinterpret_cast<char *>(&file_bits), sizeof(file_bits));
+    file.read(reinterpret_cast<char *>(&file_iterations),
+              sizeof(file_iterations));
+    file.read(reinterpret_cast<char *>(&length), sizeof(length));
+    if (!file || tag != file_tag || real != center_real ||
+        im != center_im || length == 0 ||
+        length > static_cast<std::uint64_t>(file_iterations) + 1) {
+      return;
+    }
+    ReferenceOrbit orbit;
+    orbit.offset = file_offset;
+    orbit.c = std::complex<double>(
+        center_real + std::ldexp(file_offset.real(), file_exponent),
+        center_im + std::ldexp(file_offset.imag(), file_exponent));
+    orbit.scale_exponent = file_exponent;
+    orbit.z.resize(length);
+    file.read(reinterpret_cast<char *>(orbit.z.data()),
+              length * sizeof(std::complex<double>));
+    if (!file) {
+      return;
+    }
+    shared = std::make_shared<const ReferenceOrbit>(std::move(orbit));
+    offset = file_offset;
+    offset_exponent = file_exponent;
+    bits = file_bits;
+    iterations = file_iterations;
+  }
+
+  void save() const {
+    // tag, center, offset and its exponent, bits, iterations, length of the
+    // orbit, orbit
+    std::ofstream file(filename, std::ios::binary);
+    const std::int32_t file_exponent = offset_exponent, file_bits = bits,
+                       file_iterations = iterations;
+    const std::uint64_t length = shared->z.size();
+    file.write(reinterpret_cast<const char *>(&file_tag), sizeof(file_tag));
+    file.write(reinterpret_cast<const char *>(&center_real),
+               sizeof(center_real));
+    file.write(reinterpret_cast<const char *>(&center_im), sizeof(center_im));
+    file.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+    file.write(reinterpret_cast<const char *>(&file_exponent),
+               sizeof(file_exponent));
+    file.write(reinterpret_cast<const char *>(&file_bits), sizeof(file_bits));
+    file.write(reinterpret_cast<const char *>(&file_iterations),
+               sizeof(file_iterations));
+    file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    file.write(reinterpret_cast<const char *>(shared->z.data()),
+               length * sizeof(std::complex<double>));
+  }
+
+public:
+  ReferenceCache(const double &center_real, const double &center_im,
+                 const std::string &filename = "")
+      : center_real(center_real), center_im(center_im), filename(filename) {
+    if (!filename.empty()) {
+      load();
+    }
+  }
+
+  int getBits() const { return bits; }
+  int getIterations() const { return iterations; }
+  std::complex<double> getCenter() const {
+    return std::complex<double>(center_real, center_im);
+  }
+  std::complex<double> getOffset() const { return offset; }
+
+  void set_reference(const std::complex<double> &reference_offset,
+                     const int &reference_exponent) {
+    /*
+      moves the reference point to center + reference_offset
+      2**reference_exponent, say the nucleus of the deepest frame of the
+      zoom (see find_nucleus); the orbit is computed again unless it already
+      is the one of that point
+    */
+    std::lock_guard<std::mutex> lock(mutex);
+    if (reference_offset == offset && reference_exponent == offset_exponent) {
+      return;
+    }
+    offset = reference_offset;
+    offset_exponent = reference_exponent;
+    shared = nullptr;
+    bits = -1;
+    extend = nullptr;
+  }
+
+  std::shared_ptr<const ReferenceOrbit> orbit(const int &max_iter,
+                                              const double &pixel_spacing,
+                                              const int &scale_exponent = 0) {
+    /*
+      same as compute_reference_orbit(center, offset, max_iter,
+      pixel_spacing, scale_exponent), possibly longer and more precise
+      the orbit stays valid after the cache changes; frames in other units
+      than the orbit get a copy with the offset in their units
+    */
+    std::lock_guard<std::mutex> lock(mutex);
+    int needed = reference_bits(pixel_spacing, scale_exponent);
+    if (offset != 0.0) {
+      // the reference point itself must be exact
+      needed = std::max(needed, reference_bits(std::abs(offset),
+                                               offset_exponent));
+    }
+    if (needed > bits || (max_iter > iterations && !extend)) {
+      ReferenceOrbit computed;
+      bits = std::max(bits, needed);
+      iterations = std::max(iterations, max_iter);
+      extend = start_reference_orbit(computed, center_real, center_im,
+                                     offset, bits, offset_exponent);
+      extend(computed, iterations);
+      shared = std::make_shared<const ReferenceOrbit>(std::move(computed));
+    } else if (max_iter > iterations) {
+      // readers keep the orbit they hold, the longer one is a new copy
+      ReferenceOrbit extended = *shared;
+      iterations = max_iter;
+      extend(extended, iterations);
+      shared = std::make_shared<const ReferenceOrbit>(std::move(extended));
+    } else {
+      return scaled_orbit(scale_exponent);
+    }
+    if (!filename.empty()) {
+      save();
+    }
+    return scaled_orbit(scale_exponent);
+  }
+};
+
+// Pauldelbrot's criterion: the perturbed orbit is no longer trustworthy when
+// |Z + dz| < 1e-3 |Z|, the tolerance is on the squares of the two
+const double glitch_tolerance = 1e-6;
+
+// most reference orbits a frame may use to correct its glitches
+const int max_references = 64;
+
+// a linear step is trusted while the dz**2 it drops is negligible against
+// 2 Z dz: |dz| < bla_epsilon |Z| (2**-24, the usual choice for double; at
+// 2**-53 the steps would be exact but too short to ever be used)
+const double bla_epsilon = 5.9604644775390625e-08;
+
+struct BlaStep {
+  // skips 2**level iterations at once: dz -> a * dz + b * dc, for every pixel
+  // of the frame whose dz is smaller than radius when it gets there
+  std::complex<double> a;
+  std::complex<double> b;
+  double radius2; // radius squared
+};
+
+struct BlaTable {
+  // bivariate linear approximation of the reference orbit: levels[0][m - 1]
+  // steps from iteration m to m + 1, levels[l][j] merges levels[l - 1][2 j]
+  // and levels[l - 1][2 j + 1], stepping from 1 + j 2**l to 1 + (j + 1) 2**l
+  std::vector<std::vector<BlaStep>> levels;
+  double max_radius2 = 0.0; // no step is valid for a larger |dz|**2
+};
+
+BlaTable bla_table(const ReferenceOrbit &orbit, const double &dc_max) {
+  /*
+    builds the table of linear steps of an orbit for the pixels of a frame
+    dc_max: largest |dc| of the pixels using the orbit
+
+    the single steps drop dz**2 from dz = 2 Z dz + dz**2 + dc:
+      a = 2 Z_m, b = 1, radius = bla_epsilon |Z_m|
+    two consecutive steps x then y merge into
+      a = a_y a_x, b = a_y b_x + b_y,
+      radius = min(radius_x, (radius_y - |b_x| dc_max) / |a_x|)
+    so that the merged step is valid wherever both of its halves are
+
+    the table holds about 2 orbit.z.size() steps
+  */
+  BlaTable table;
+  const int steps = static_cast<int>(orbit.z.size()) - 2;
+  if (steps < 1) {
+    return table;
+  }
+  std::vector<BlaStep> level(steps);
+  for (int m = 1; m <= steps; ++m) {
+    const double radius = bla_epsilon * std::abs(orbit.z[m]);
+    level[m - 1] = {2.0 * orbit.z[m], 1.0, radius * radius};
+    table.max_radius2 = std::max(table.max_radius2, radius * radius);
+  }
+  table.levels.push_back(std::move(level));
+  while (table.levels.back().size() > 1) {
+    const std::vector<BlaStep> &lower = table.levels.back();
+    std::vector<BlaStep> upper(lower.size() / 2);
+    for (std::size_t j = 0; j < upper.size(); ++j) {
+      const BlaStep &x = lower[2 * j];
+      const BlaStep &y = lower[2 * j + 1];
+      double radius = 0.0;
+      const double a_x = std::abs(x.a);
+      if (x.radius2 > 0.0 && a_x > 0.0) {
+        radius = std::min(std::sqrt(x.radius2),
+                          (std::sqrt(y.radius2) - std::abs(x.b) * dc_max) /
+                              a_x);
+      }
+      radius = std::isfinite(radius) ? std::max(0.0, radius) : 0.0;
+      upper[j] = {y.a * x.a, y.a * x.b + y.b, radius * radius};
+    }
+    table.levels.push_back(std::move(upper));
+  }
+  return table;
+}
+
+// frames are in units of 2**scale_exponent when they are deeper than double
+// can represent (see ReferenceOrbit); their pixels iterate rescaled until dz
+// is above 2**rescaled_exponent, renormalizing it when it grows past
+// 2**rescale_bits
+const int rescaled_exponent = -960;
+const int rescale_bits = 64;
+
+int rescaled_iterations(const ReferenceOrbit &orbit, std::complex<double> &dz,
+                        std::complex<double> &dc, const int &first_iteration,
+                        const int &last_iteration) {
+  /*
+    first iterations of a pixel of a frame past the range of double, where
+    dz itself would underflow: dz = 2**e w and dc = 2**e d with w and d
+    doubles and e an int, so that
+      w = 2 Z w + 2**e w**2 + d
+    all in double, 2**e w**2 vanishing while e is very negative. When w
+    grows past 2**rescale_bits, w and d are divided by a power of two and e
+    increased by it; d eventually underflows, when it has become negligible
+    against w. No pixel can escape or glitch here, dz being far smaller than
+    any Z
+    dz, dc: in units of 2**orbit.scale_exponent on entry, plain doubles on
+    exit (dc possibly rounded to 0)
+    first_iteration: iterations already done (by the series approximation)
+    last_iteration: no more iterations than this
+
+    returns the iteration reached, with dz above 2**rescaled_exponent unless
+    it is last_iteration
+  */
+  int exponent = orbit.scale_exponent;
+  double scale = std::ldexp(1.0, exponent);
+  double w_real = dz.real();
+  double w_im = dz.imag();
+  double d_real = dc.real();
+  double d_im = dc.imag();
+  const double threshold = std::ldexp(1.0, rescale_bits);
+  int it = first_iteration;
+  for (; it < last_iteration; ++it) {
+    const double largest = std::max(std::abs(w_real), std::abs(w_im));
+    if (largest > threshold || it == first_iteration) {
+      if (largest > 0.0) {
+        const int shift = std::ilogb(largest);
+        w_real = std::ldexp(w_real, -shift);
+        w_im = std::ldexp(w_im, -shift);
+        d_real = std::ldexp(d_real, -shift);
+        d_im = std::ldexp(d_im, -shift);
+        exponent += shift;
+        scale = std::ldexp(1.0, exponent);
+      }
+      if (exponent > rescaled_exponent) {
+        break;
+      }
+    }
+    const double z_real = orbit.z[it].real();
+    const double z_im = orbit.z[it].imag();
+    const double next_real = 2 * (z_real * w_real - z_im * w_im) +
+                             scale * (w_real * w_real - w_im * w_im) + d_real;
+    w_im = 2 * (z_real * w_im + z_im * w_real) + scale * 2 * w_real * w_im +
+           d_im;
+    w_real = next_real;
+  }
+  dz = std::complex<double>(std::ldexp(w_real, exponent),
+                            std::ldexp(w_im, exponent));
+  dc = std::complex<double>(std::ldexp(d_real, exponent),
+                            std::ldexp(d_im, exponent));
+  return it;
+}
+
+int perturbed_num_iter(const ReferenceOrbit &orbit,
+                       const std::complex<double> &dc, const int &max_iter,
+                       double *glitch = nullptr, const int &first_iteration = 0,
+                       const std::complex<double> &first_dz = 0.0,
+                       const BlaTable *bla = nullptr) {
+  /*
+    same as num_iter(0, C + dc, max_iter) for the reference point C of orbit,
+    iterating only the difference dz between the orbit of the pixel and the
+    one of the reference
+    dc: pixel minus the reference point
+    glitch: if not nullptr, receives |Z + dz|^2 / |Z|^2 when the pixel
+    glitches (then its number of iterations is meaningless), -1 otherwise
+    first_iteration, first_dz: where the iterations start from, dz after
+    first_iteration iterations when they are skipped by a series
+    approximation
+    for frames in units of 2**orbit.scale_exponent, dc and first_dz are in
+    those units and the first iterations go through rescaled_iterations
+    bla: if not nullptr, linear steps of orbit for the frame of the pixel,
+    the largest valid one replaces the iterations it covers
+
+    a pixel glitches when its orbit gets so close to 0 compared to the one of
+    the reference that dz loses all its digits (Pauldelbrot's criterion), or
+    when the reference escapes before the pixel: the remaining iterations are
+    then done directly in double, which is only right at shallow zoom
+  */
+  if (glitch != nullptr) {
+    *glitch = -1.0;
+  }
+  const int last = orbit.z.size() - 1;
+  std::complex<double> start_dz = first_dz;
+  std::complex<double> start_dc = dc;
+  int start = first_iteration;
+  if (orbit.scale_exponent != 0) {
+    start = rescaled_iterations(orbit, start_dz, start_dc, first_iteration,
+                                std::min(last, max_iter));
+  }
+  const double dc_real = start_dc.real();
+  const double dc_im = start_dc.imag();
+  double dz_real = start_dz.real();
+  double dz_im = start_dz.imag();
+  const BlaStep *bla_steps = nullptr;
+  const int bla_limit = std::min(last, max_iter);
+  double bla_radius2 = 0.0;
+  if (bla != nullptr && !bla->levels.empty()) {
+    bla_steps = bla->levels[0].data();
+    bla_radius2 = bla->max_radius2;
+  }
+  for (int it = start; it < max_iter; ++it) {
+    const double z_real = orbit.z[it].real();
+    const double z_im = orbit.z[it].imag();
+    const double pixel_real = z_real + dz_real;
+    const double pixel_im = z_im + dz_im;
+    const double pixel_norm = pixel_real * pixel_real + pixel_im * pixel_im;
+    if (pixel_norm >= 4) {
+      return it;
+    }
+    if (glitch != nullptr &&
+        pixel_norm < glitch_tolerance * (z_real * z_real + z_im * z_im)) {
+      *glitch = pixel_norm / (z_real * z_real + z_im * z_im);
+      return it;
+    }
+    if (it == last) {
+      // the reference escaped before this pixel, carry on without it
+      if (glitch != nullptr) {
+        *glitch = 0.0;
+      }
+      const std::complex<double> c = orbit.c + start_dc;
+      std::complex<double> z(pixel_real, pixel_im);
+      while (std::norm(z) < 4 && it < max_iter) {
+        z = z * z + c;
+        it += 1;
+      }
+      return it;
+    }
+    const double dz_norm = dz_real * dz_real + dz_im * dz_im;
+    if (dz_norm < bla_radius2 && it > 0 && it < bla_limit &&
+        dz_norm < bla_steps[it - 1].radius2) {
+      // climbs the levels aligned with it while the steps stay valid
+      const BlaStep *step = &bla_steps[it - 1];
+      int length = 1;
+      for (std::size_t level = 1; level < bla->levels.size(); ++level) {
+        const int index = (it - 1) >> level;
+        if (((it - 1) & ((1 << level) - 1)) != 0 ||
+            index >= static_cast<int>(bla->levels[level].size()) ||
+            it + (1 << level) > bla_limit ||
+            dz_norm >= bla->levels[level][index].radius2) {
+          break;
+        }
+        step = &bla->levels[level][index];
+        length = 1 << level;
+      }
+      const double a_real = step->a.real(), a_im = step->a.imag();
+      const double b_real = step->b.real(), b_im = step->b.imag();
+      const double next_real = a_real * dz_real - a_im * dz_im +
+                               b_real * dc_real - b_im * dc_im;
+      dz_im = a_real * dz_im + a_im * dz_real + b_real * dc_im + b_im * dc_real;
+      dz_real = next_real;
+      it += length - 1;
+      continue;
+    }
+    const double next_real = 2 * (z_real * dz_real - z_im * dz_im) +
+                             dz_real * dz_real - dz_im * dz_im + dc_real;
+    dz_im = 2 * (z_real * dz_im + z_im * dz_real) + 2 * dz_real * dz_im + dc_im;
+    dz_real = next_real;
+  }
+  return max_iter;
+}
+
+// terms of the series approximation, and how much smaller than the difference
+// between two neighbouring pixels its error has to stay
+const int series_terms = 8;
+const double series_tolerance = 1e-6;
+
+struct SeriesApproximation {
+  // dz after skip iterations for every pixel of a frame, as a polynomial in
+  // u = dc / radius: dz = coefficients[0] u + coefficients[1] u^2 + ...
+  int skip;
+  double radius; // largest |dc| of the frame, so that |u| <= 1
+  std::vector<std::complex<double>> coefficients;
+};
+
+std::complex<double> series_dz(const SeriesApproximation &series,
+                               const std::complex<double> &dc) {
+  // evaluates the series approximation for a pixel at dc from the reference
+  if (series.skip == 0) {
+    return 0.0;
+  }
+  const std::complex<double> u = dc / series.radius;
+  std::complex<double> dz = 0.0;
+  for (int k = series.coefficients.size() - 1; k >= 0; --k) {
+    dz = (dz + series.coefficients[k]) * u;
+  }
+  return dz;
+}
+
+SeriesApproximation
+series_iterations(const ReferenceOrbit &orbit, const double &radius,
+                  const double &pixel_spacing, const int &max_skip) {
+  /*
+    iterates the coefficients of the series, scaled by powers of radius so
+    that they stay in the range of double, (a_1 u + a_2 u^2 + ...) being dz:
+      a_1 = 2 Z a_1 + radius, a_k = 2 Z a_k + sum_{i + j = k} a_i a_j
+    the first neglected term (series_terms + 1) estimates the truncation
+    error, the series is valid while it is series_tolerance times smaller
+    than the difference between two pixels, about |a_1| pixel_spacing /
+    radius, and while no pixel may have escaped: |Z| + sum |a_k| < 2
+    max_skip: the series stops after at most max_skip iterations
+
+    for frames in units of 2**orbit.scale_exponent the products of two
+    coefficients are scaled by it too, and the series also stops when the
+    coefficients overflow
+
+    returns the coefficients after the last valid iteration
+  */
+  const int terms = series_terms + 1;
+  std::vector<std::complex<double>> a(terms, 0.0);
+  std::vector<std::complex<double>> next(terms, 0.0);
+  SeriesApproximation series = {0, radius,
+                                std::vector<std::complex<double>>(
+                                    series_terms, 0.0)};
+  const int last = std::min<int>(max_skip, orbit.z.size() - 1);
+  const double scale = std::ldexp(1.0, orbit.scale_exponent);
+  for (int n = 0; n < last; ++n) {
+    const std::complex<double> two_z = 2.0 * orbit.z[n];
+    next[0] = two_z * a[0] + radius;
+    for (int k = 1; k < terms; ++k) {
+      next[k] = two_z * a[k];
+      for (int i = 0; i < k; ++i) {
+        next[k] += scale * a[i] * a[k - 1 - i];
+      }
+    }
+    a.swap(next);
+
+    double bound = 0.0;
+    for (int k = 0; k < series_terms; ++k) {
+      bound += std::abs(a[k]);
+    }
+    const double pixel_step = std::abs(a[0]) * pixel_spacing / radius;
+    if (std::abs(a[series_terms]) > series_tolerance * pixel_step ||
+        std::abs(orbit.z[n + 1]) + std::ldexp(bound, orbit.scale_exponent) >=
+            2.0 ||
+        !std::isfinite(bound)) {
+      break;
+    }
+    series.skip = n + 1;
+    std::copy(a.begin(), a.begin() + series_terms,
+              series.coefficients.begin());
+  }
+  return series;
+}
+
+SeriesApproximation
+series_approximation(const ReferenceOrbit &orbit,
+                     const std::vector<std::complex<double>> &probes,
+                     const double &pixel_spacing, const int &max_iter) {
+  /*
+    series approximation starting every pixel of a region of the frame at the
+    same iteration instead of 0: at deep zoom all the pixels follow nearly the
+    same orbit for thousands of iterations, dz being a well behaved function
+    of dc that a short polynomial describes
+    probes: dc of some pixels around the region (its corners), the furthest
+    sets the radius of the series; they are also iterated one by one and the
+    number of iterations skipped is halved until the series agrees with them
+    pixel_spacing: distance between two neighbouring pixels
+
+    returns the series, skipping 0 iterations if no useful series exists
+  */
+  double radius = 0.0;
+  for (const std::complex<double> &probe : probes) {
+    radius = std::max(radius, std::abs(probe));
+  }
+  if (radius == 0.0) {
+    return {0, 1.0, {}};
+  }
+  SeriesApproximation series =
+      series_iterations(orbit, radius, pixel_spacing, max_iter - 1);
+  const double scale = std::ldexp(1.0, orbit.scale_exponent);
+  while (series.skip > 0) {
+    const double pixel_step =
+        std::abs(series.coefficients[0]) * pixel_spacing / radius;
+    bool agree = true;
+    for (const std::complex<double> &probe : probes) {
+      std::complex<double> dz = 0.0;
+      for (int n = 0; n < series.skip; ++n) {
+        dz = 2.0 * orbit.z[n] * dz + scale * dz * dz + probe;
+      }
+      agree &= std::abs(dz - series_dz(series, probe)) <=
+               series_tolerance * pixel_step;
+    }
+    if (agree) {
+      break;
+    }
+    series = series_iterations(orbit, radius, pixel_spacing, series.skip / 2);
+  }
+  return series;
+}
+
+std::complex<double> pixel_offset(const int &index, const int &dim,
+                                  const double &z_real_bound,
+                                  const double &z_im_bound,
+                                  const std::complex<double> &corner) {
+  // position of a pixel of a board with respect to the center of the zoom
+  return std::complex<double>((index % dim) * z_real_bound + corner.real(),
+                              (index / dim) * z_im_bound + corner.imag());
+}
+
+void perturbation_pixels(std::vector<double> &board,
+                         std::vector<double> &glitches, const int &dim,
+                         const int *pixels, const int &num_pixels,
+                         const double &z_real_bound, const double &z_im_bound,
+                         const std::complex<double> &corner,
+                         const ReferenceOrbit &orbit,
+                         const SeriesApproximation &series,
+                         const BlaTable *bla, const int &max_iter,
+                         const bool &julia = false) {
+  /*
+    colors some pixels of a board by perturbation, pixel (x, y) is at
+    center + corner + (x * z_real_bound, y * z_im_bound)
+    glitches: receives the glitch value of each pixel (see perturbed_num_iter)
+    pixels: indices (y * dim + x) of the pixels
+    z_real_bound, z_im_bound: distance between two pixels
+    corner: pixel (0, 0) minus the center of the zoom
+    orbit: reference orbit, its offset is subtracted from every pixel
+    series: series approximation of the pixels around orbit, their first
+    series.skip iterations are not computed
+    bla: linear steps of orbit for the pixels, nullptr to iterate every step
+    julia: the board shows the julia set of orbit.c, every pixel starts its
+    orbit as far from the reference as it is (dz = delta) with the same c
+    (dc = 0); series is not used
+  */
+  for (int i = 0; i < num_pixels; ++i) {
+    const int pixel = pixels[i];
+    const std::complex<double> delta =
+        pixel_offset(pixel, dim, z_real_bound, z_im_bound, corner) -
+        orbit.offset;
+    const int number_iterations =
+        julia ? perturbed_num_iter(orbit, 0.0, max_iter, &glitches[pixel], 0,
+                                   delta, bla)
+              : perturbed_num_iter(orbit, delta, max_iter, &glitches[pixel],
+                                   series.skip, series_dz(series, delta), bla);
+    board[pixel] = 1.0 - number_iterations / static_cast<double>(max_iter);
+  }
+}
+
+std::vector<std::complex<double>>
+region_probes(const ReferenceOrbit &orbit, const int *pixels,
+              const int &num_pixels, const int &dim,
+              const double &z_real_bound, const double &z_im_bound,
+              const std::complex<double> &corner) {
+  /*
+    dc of the corners and of the middle of the edges of the rectangle around
+    some pixels of a board: the series approximation of the pixels is probed
+    there and the furthest one bounds the dc of all of them
+  */
+  int min_x = dim, min_y = dim, max_x = 0, max_y = 0;
+  for (int i = 0; i < num_pixels; ++i) {
+    min_x = std::min(min_x, pixels[i] % dim);
+    max_x = std::max(max_x, pixels[i] % dim);
+    min_y = std::min(min_y, pixels[i] / dim);
+    max_y = std::max(max_y, pixels[i] / dim);
+  }
+  std::vector<std::complex<double>> probes;
+  for (const int x : {min_x, (min_x + max_x) / 2, max_x}) {
+    for (const int y : {min_y, (min_y + max_y) / 2, max_y}) {
+      if (x != (min_x + max_x) / 2 || y != (min_y + max_y) / 2) {
+        probes.push_back(pixel_offset(y * dim + x, dim, z_real_bound,
+                                      z_im_bound, corner) -
+                         orbit.offset);
+      }
+    }
+  }
+  return probes;
+}
+
+struct PerturbationReference {
+  // a reference orbit and what accelerates the pixels around it, the orbit
+  // may be shared with other frames (see ReferenceCache)
+  std::shared_ptr<const ReferenceOrbit> orbit;
+  SeriesApproximation series;
+  BlaTable bla;
+};
+
+PerturbationReference
+perturbation_reference(std::shared_ptr<const ReferenceOrbit> orbit,
+                       const int *pixels,
+                       const int &num_pixels, const int &dim,
+                       const double &z_real_bound, const double &z_im_bound,
+                       const std::complex<double> &corner, const int &max_iter,
+                       const bool &use_series, const bool &use_bla) {
+  /*
+    prepares the series approximation and the linear steps of orbit for some
+    pixels of a board, either can be left empty (the steps are not built when
+    the series already skips every iteration)
+  */
+  const std::vector<std::complex<double>> probes = region_probes(
+      *orbit, pixels, num_pixels, dim, z_real_bound, z_im_bound, corner);
+  PerturbationReference reference = {std::move(orbit), {0, 1.0, {}}, {}};
+  if (use_series) {
+    reference.series =
+        series_approximation(*reference.orbit, probes,
+                             std::min(z_real_bound, z_im_bound), max_iter);
+  }
+  if (use_bla && reference.series.skip < max_iter - 1) {
+    double dc_max = 0.0;
+    for (const std::complex<double> &probe : probes) {
+      dc_max = std::max(dc_max, std::abs(probe));
+    }
+    // the steps only start once dz is out of the rescaled iterations
+    reference.bla = bla_table(
+        *reference.orbit,
+        std::ldexp(dc_max, reference.orbit->scale_exponent));
+  }
+  return reference;
+}
+
+void perturbation_rows(std::vector<double> &board, const int &dim,
+                       const int &first_row, const int &last_row,
+                       const double &z_real_bound, const double &z_im_bound,
+                       const std::complex<double> &corner,
+                       const ReferenceOrbit &orbit, const int &max_iter) {
+  /*
+    colors the rows first_row ... last_row - 1 of a board by perturbation
+    with a single reference, glitches included (see perturbation_pixels)
+  */
+  for (int y = first_row; y < last_row; ++y) {
+    for (int x = 0; x < dim; ++x) {
+      const std::complex<double> dc =
+          pixel_offset(y * dim + x, dim, z_real_bound, z_im_bound, corner) -
+          orbit.offset;
+      const int number_iterations = perturbed_num_iter(orbit, dc, max_iter);
+      board[y * dim + x] =
+          1.0 - number_iterations / static_cast<double>(max_iter);
+    }
+  }
+}
+
+std::vector<std::vector<int>>
+glitched_regions(const std::vector<double> &glitches, const int &dim) {
+  /*
+    groups the glitched pixels of a board in regions of pixels touching each
+    other horizontally or vertically
+
+    returns the indices of the pixels of every region
+  */
+  std::vector<std::vector<int>> regions;
+  std::vector<bool> visited(glitches.size(), false);
+  for (int start = 0; start < static_cast<int>(glitches.size()); ++start) {
+    if (glitches[start] < 0 || visited[start]) {
+      continue;
+    }
+    std::vector<int> region = {start};
+    visited[start] = true;
+    for (std::size_t next = 0; next < region.size(); ++next) {
+      const int x = region[next] % dim;
+      const int y = region[next] / dim;
+      const int neighbours[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1},
+                                    {x, y + 1}};
+      for (const auto &neighbour : neighbours) {
+        const int nx = neighbour[0];
+        const int ny = neighbour[1];
+        if (nx < 0 || ny < 0 || nx >= dim || ny >= dim) {
+          continue;
+        }
+        const int index = ny * dim + nx;
+        if (glitches[index] >= 0 && !visited[index]) {
+          visited[index] = true;
+          region.push_back(index);
+        }
+      }
+    }
+    regions.push_back(std::move(region));
+  }
+  return regions;
+}
+
+struct PerturbationStats {
+  // how a perturbation frame was rendered
+  int references;      // reference orbits used, the first one included
+  int glitched_pixels; // pixels still glitched when the references ran out
+  int skipped;         // iterations skipped by the series of the first one
+};
+
+void correct_glitches(
+    std::vector<double> &board, std::vector<double> &glitches, const int &dim,
+    const bool &parallel, PerturbationStats &stats,
+    const std::function<void(const std::vector<int> &, const int &)>
+        &render_region) {
+  /*
+    renders the glitched pixels of a board again until there are none or
+    max_references were used: they are grouped in connected regions, and
+    each region is rendered around a reference of its own, the pixel of the
+    region that glitched the hardest (nearest to the center of the minibrot
+    or of the spiral causing the glitch, or the longest lived one if the
+    reference escaped before them)
+    render_region: renders a region (pixel indices) around a reference pixel,
+    updating board and glitches
+  */
+  std::vector<std::vector<int>> regions = glitched_regions(glitches, dim);
+  while (!regions.empty() && stats.references < max_references) {
+    // the biggest regions first, in case the references run out
+    std::sort(regions.begin(), regions.end(),
+              [](const std::vector<int> &a, const std::vector<int> &b) {
+                return a.size() > b.size();
+              });
+    regions.resize(std::min<int>(regions.size(),
+                                 max_references - stats.references));
+    stats.references += regions.size();
+
+    auto correct = [&](const int &r) {
+      const std::vector<int> &region = regions[r];
+      // among pixels that outlived the reference the one iterated the most
+      const int reference = *std::min_element(
+          region.begin(), region.end(), [&](const int &a, const int &b) {
+            return glitches[a] < glitches[b] ||
+                   (glitches[a] == glitches[b] && board[a] < board[b]);
+          });
+      render_region(region, reference);
+    };
+    if (parallel) {
+      parallel_jobs(regions.size(), correct);
+    } else {
+      for (int r = 0; r < static_cast<int>(regions.size()); ++r) {
+        correct(r);
+      }
+    }
+    regions = glitched_regions(glitches, dim);
+  }
+  for (const std::vector<int> &region : regions) {
+    stats.glitched_pixels += region.size();
+  }
+}
+
+PerturbationStats perturbation_board(
+    std::vector<double> &board, const int &dim, const double &z_real_bound,
+    const double &z_im_bound, const std::complex<double> &corner,
+    const double &center_real, const double &center_im, const int &max_iter,
+    const bool &parallel = false, const bool &use_series = true,
+    const bool &use_bla = true, const int &scale_exponent = 0,
+    ReferenceCache *cache = nullptr, const bool &use_nucleus = false) {
+  /*
+    colors a board by perturbation around the zoom center, then corrects its
+    glitches with more references (see correct_glitches)
+    parallel: spread rows and regions over the shared pool, only for frames
+    not already rendered by a job of the pool
+    use_series: skip the first iterations of every reference with a series
+    approximation (see series_approximation)
+    use_bla: jump over the iterations of every reference where the pixels
+    are linear in dz and dc (see bla_table)
+    scale_exponent: z_real_bound, z_im_bound and corner are in units of
+    2**scale_exponent, for frames deeper than the range of double
+    cache: if not nullptr, where the first reference orbit comes from,
+    shared with the other frames of the zoom
+    use_nucleus: without a cache, the first reference is the nucleus of the
+    minibrot of lowest period in the frame if there is one, not the center
+    (see nucleus_reference_orbit)
+
+    returns the number of references used and of pixels left glitched
+  */
+  std::vector<double> glitches(dim * dim, -1.0);
+  std::vector<int> rows(dim * dim);
+  for (int i = 0; i < dim * dim; ++i) {
+    rows[i] = i;
+  }
+  const double pixel_spacing = std::min(z_real_bound, z_im_bound);
+  std::shared_ptr<const ReferenceOrbit> first_orbit;
+  if (cache != nullptr) {
+    first_orbit = cache->orbit(max_iter, pixel_spacing, scale_exponent);
+  } else if (use_nucleus) {
+    first_orbit = std::make_shared<const ReferenceOrbit>(
+        nucleus_reference_orbit(
+            center_real, center_im, corner,
+            corner + std::complex<double>((dim - 1) * z_real_bound,
+                                          (dim - 1) * z_im_bound),
+            max_iter, pixel_spacing, scale_exponent));
+  } else {
+    first_orbit = std::make_shared<const ReferenceOrbit>(
+        compute_reference_orbit(center_real, center_im,
+                                std::complex<double>(0.0, 0.0), max_iter,
+                                pixel_spacing, scale_exponent));
+  }
+  const PerturbationReference frame = perturbation_reference(
+      std::move(first_orbit),
+      rows.data(), dim * dim, dim, z_real_bound, z_im_bound, corner, max_iter,
+      use_series, use_bla);
+  const BlaTable *frame_bla = use_bla ? &frame.bla : nullptr;
+  PerturbationStats stats = {1, 0, frame.series.skip};
+  if (parallel) {
+    parallel_jobs(dim, [&](const int &row) {
+      perturbation_pixels(board, glitches, dim, &rows[row * dim], dim,
+                          z_real_bound, z_im_bound, corner, *frame.orbit,
+                          frame.series, frame_bla, max_iter);
+    });
+  } else {
+    perturbation_pixels(board, glitches, dim, rows.data(), dim * dim,
+                        z_real_bound, z_im_bound, corner, *frame.orbit,
+                        frame.series, frame_bla, max_iter);
+  }
+
+  correct_glitches(
+      board, glitches, dim, parallel, stats,
+      [&](const std::vector<int> &region, const int &reference) {
+        const PerturbationReference region_reference = perturbation_reference(
+            std::make_shared<const ReferenceOrbit>(compute_reference_orbit(
+                center_real, center_im,
+                pixel_offset(reference, dim, z_real_bound, z_im_bound,
+                             corner),
+                max_iter, pixel_spacing, scale_exponent)),
+            region.data(), region.size(), dim, z_real_bound, z_im_bound,
+            corner, max_iter, use_series, use_bla);
+        perturbation_pixels(
+            board, glitches, dim, region.data(), region.size(), z_real_bound,
+            z_im_bound, corner, *region_reference.orbit,
+            region_reference.series,
+            use_bla ? &region_reference.bla : nullptr, max_iter);
+      });
+  return stats;
+}
+
+PerturbationStats julia_perturbation_board(
+    std::vector<double> &board, const int &dim, const double &z_real_bound,
+    const double &z_im_bound, const std::complex<double> &corner,
+    const double &center_real, const double &center_im,
+    const std::complex<double> &c, const int &max_iter,
+    const bool &parallel = false, const bool &use_bla = true,
+    const int &scale_exponent = 0) {
+  /*
+    same as perturbation_board for the julia set of c: the reference orbit
+    starts at a point of the frame (the zoom center first) instead of 0 and
+    every pixel iterates its difference from it, dz = 2 Z dz + dz**2 starting
+    from dz = pixel - reference, c being the same for every pixel. The
+    references are per starting point, so the glitches are corrected the
+    same way; there is no series approximation, dz not being a function of
+    a dc shared by the pixels
+    c: exact in double, the orbits are computed with it as it is
+  */
+  std::vector<double> glitches(dim * dim, -1.0);
+  std::vector<int> rows(dim * dim);
+  for (int i = 0; i < dim * dim; ++i) {
+    rows[i] = i;
+  }
+  const int bits =
+      reference_bits(std::min(z_real_bound, z_im_bound), scale_exponent);
+  auto julia_reference = [&](const std::complex<double> &offset) {
+    ReferenceOrbit orbit;
+    start_reference_orbit(orbit, center_real, center_im, offset, bits,
+                          scale_exponent, &c)(orbit, max_iter);
+    PerturbationReference reference = {
+        std::make_shared<const ReferenceOrbit>(std::move(orbit)),
+        {0, 1.0, {}},
+        {}};
+    if (use_bla) {
+      // no dc: the merged steps are as long as their halves allow
+      reference.bla = bla_table(*reference.orbit, 0.0);
+    }
+    return reference;
+  };
+
+  const PerturbationReference frame = julia_reference(0.0);
+  const BlaTable *frame_bla = use_bla ? &frame.bla : nullptr;
+  PerturbationStats stats = {1, 0, 0};
+  if (parallel) {
+    parallel_jobs(dim, [&](const int &row) {
+      perturbation_pixels(board, glitches, dim, &rows[row * dim], dim,
+                          z_real_bound, z_im_bound, corner, *frame.orbit,
+                          frame.series, frame_bla, max_iter, true);
+    });
+  } else {
+    perturbation_pixels(board, glitches, dim, rows.data(), dim * dim,
+                        z_real_bound, z_im_bound, corner, *frame.orbit,
+                        frame.series, frame_bla, max_iter, true);
+  }
+
+  correct_glitches(
+      board, glitches, dim, parallel, stats,
+      [&](const std::vector<int> &region, const int &reference) {
+        const PerturbationReference region_reference =
+            julia_reference(pixel_offset(reference, dim, z_real_bound,
+                                         z_im_bound, corner));
+        perturbation_pixels(
+            board, glitches, dim, region.data(), region.size(), z_real_bound,
+            z_im_bound, corner, *region_reference.orbit,
+            region_reference.series,
+            use_bla ? &region_reference.bla : nullptr, max_iter, true);
+      });
+  return stats;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cmath>
+
+// Double-double numbers: an unevaluated sum hi + lo of two doubles with
+// |lo| <= ulp(hi) / 2, about 106 bits of mantissa. Every operation is a few
+// double operations made exact with the error-free transformations two_sum
+// and two_prod, so that frames stay sharp down to scaling factors of about
+// 1e-28 without leaving hardware arithmetic (see Hida, Li, Bailey, "Library
+// for double-double and quad-double arithmetic")
+
+struct DoubleDouble {
+  double hi = 0.0;
+  double lo = 0.0;
+
+  DoubleDouble() = default;
+  DoubleDouble(const double &value) : hi(value), lo(0.0) {}
+  DoubleDouble(const double &hi, const double &lo) : hi(hi), lo(lo) {}
+
+  explicit operator double() const { return hi + lo; }
+};
+
+inline DoubleDouble quick_two_sum(const double &a, const double &b) {
+  // a + b exactly, for |a| >= |b|
+  const double sum = a + b;
+  return {sum, b - (sum - a)};
+}
+
+inline DoubleDouble two_sum(const double &a, const double &b) {
+  // a + b exactly
+  const double sum = a + b;
+  const double b_virtual = sum - a;
+  return {sum, (a - (sum - b_virtual)) + (b - b_virtual)};
+}
+
+inline DoubleDouble two_prod(const double &a, const double &b) {
+  /*
+    a * b exactly: with a fused multiply-add when the hardware has one,
+    otherwise splitting a and b in halves of 26 bits (Dekker), the two give
+    the same result
+  */
+  const double product = a * b;
+#ifdef FP_FAST_FMA
+  return {product, std::fma(a, b, -product)};
+#else
+  const double split = 134217729.0; // 2**27 + 1
+  const double a_big = split * a;
+  const double a_hi = a_big - (a_big - a);
+  const double a_lo = a - a_hi;
+  const double b_big = split * b;
+  const double b_hi = b_big - (b_big - b);
+  const double b_lo = b - b_hi;
+  return {product, ((a_hi * b_hi - product) + a_hi * b_lo + a_lo * b_hi) +
+                       a_lo * b_lo};
+#endif
+}
+
+inline DoubleDouble operator+(const DoubleDouble &a, const DoubleDouble &b) {
+  // keeps the low parts even when the high parts cancel, as in z**2 + c
+  const DoubleDouble high = two_sum(a.hi, b.hi);
+  const DoubleDouble low = two_sum(a.lo, b.lo);
+  const DoubleDouble sum = quick_two_sum(high.hi, high.lo + low.hi);
+  return quick_two_sum(sum.hi, sum.lo + low.lo);
+}
+
+inline DoubleDouble operator-(const DoubleDouble &a) { return {-a.hi, -a.lo}; }
+
+inline DoubleDouble operator-(const DoubleDouble &a, const DoubleDouble &b) {
+  return a + -b;
+}
+
+inline DoubleDouble operator*(const DoubleDouble &a, const DoubleDouble &b) {
+  DoubleDouble product = two_prod(a.hi, b.hi);
+  product.lo += a.hi * b.lo + a.lo * b.hi;
+  return quick_two_sum(product.hi, product.lo);
+}
+
+inline DoubleDouble square(const DoubleDouble &a) {
+  DoubleDouble product = two_prod(a.hi, a.hi);
+  product.lo += 2.0 * a.hi * a.lo;
+  return quick_two_sum(product.hi, product.lo);
+}
+
+inline bool operator<(const DoubleDouble &a, const DoubleDouble &b) {
+  return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+inline bool operator==(const DoubleDouble &a, const DoubleDouble &b) {
+  return a.hi == b.hi && a.lo == b.lo;
+}
+
+template <int Lanes>
+void num_iter_double_double_lanes(const DoubleDouble *z_real,
+                                  const DoubleDouble *z_im,
+                                  const DoubleDouble *c_real,
+                                  const DoubleDouble *c_im, int *iterations,
+                                  const int &max_iter) {
+  /*
+    same as num_iter for Lanes points in double-double: lane l iterates
+    z = z**2 + c from z_real[l] + i z_im[l] with c_real[l] + i c_im[l], the
+    high and low parts of the lanes live in plain arrays as in num_iter_lanes
+    so that the compiler can iterate them together in SIMD registers
+    iterations: receives the Lanes numbers of iterations
+
+    about ten times slower than num_iter_lanes
+  */
+  DoubleDouble zr[Lanes];
+  DoubleDouble zi[Lanes];
+  int it[Lanes];
+  for (int l = 0; l < Lanes; ++l) {
+    zr[l] = z_real[l];
+    zi[l] = z_im[l];
+    it[l] = 0;
+  }
+  for (int n = 0; n < max_iter; ++n) {
+    int running = 0;
+    for (int l = 0; l < Lanes; ++l) {
+      const DoubleDouble zr2 = square(zr[l]);
+      const DoubleDouble zi2 = square(zi[l]);
+      const bool inside = zr2.hi + zi2.hi < 4.0;
+      const DoubleDouble product = zr[l] * zi[l];
+      const DoubleDouble next_r = zr2 - zi2 + c_real[l];
+      const DoubleDouble next_i = product + product + c_im[l];
+      zr[l] = inside ? next_r : zr[l];
+      zi[l] = inside ? next_i : zi[l];
+      it[l] += inside;
+      running += inside;
+    }
+    if (running == 0) {
+      break;
+    }
+  }
+  for (int l = 0; l < Lanes; ++l) {
+    iterations[l] = it[l];
+  }
+}
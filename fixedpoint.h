@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Fixed point numbers with Limbs 32 bit limbs: one for the integer part and
+// Limbs - 1 for the fraction, so FixedPoint<Limbs> resolves 2**-(32 (Limbs -
+// 1)). The mandelbrot iteration never leaves |x| < 8, where fixed point is as
+// good as floating point with the same number of bits and much simpler: no
+// exponents, every operation is a loop over the limbs
+
+template <int Limbs> class FixedPoint {
+  static_assert(Limbs >= 2, "FixedPoint needs a fraction limb");
+
+private:
+  // magnitude, least significant limb first: limbs[Limbs - 1] is the integer
+  // part, the value is sum limbs[k] 2**(32 (k - Limbs + 1))
+  std::array<std::uint32_t, Limbs> limbs = {};
+  bool negative = false; // never true for zero
+
+  static int compare_magnitude(const FixedPoint &a, const FixedPoint &b) {
+    // -1, 0 or 1 as |a| is smaller than, equal to or larger than |b|
+    for (int k = Limbs - 1; k >= 0; --k) {
+      if (a.limbs[k] != b.limbs[k]) {
+        return a.limbs[k] < b.limbs[k] ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+
+  static FixedPoint add_magnitudes(const FixedPoint &a, const FixedPoint &b) {
+    // |a| + |b|, the carry out of the integer limb is lost
+    FixedPoint sum;
+    std::uint64_t carry = 0;
+    for (int k = 0; k < Limbs; ++k) {
+      const std::uint64_t limb =
+          static_cast<std::uint64_t>(a.limbs[k]) + b.limbs[k] + carry;
+      sum.limbs[k] = static_cast<std::uint32_t>(limb);
+      carry = limb >> 32;
+    }
+    return sum;
+  }
+
+  static FixedPoint subtract_magnitudes(const FixedPoint &a,
+                                        const FixedPoint &b) {
+    // |a| - |b| for |a| >= |b|
+    FixedPoint difference;
+    std::int64_t borrow = 0;
+    for (int k = 0; k < Limbs; ++k) {
+      std::int64_t limb =
+          static_cast<std::int64_t>(a.limbs[k]) - b.limbs[k] - borrow;
+      borrow = limb < 0;
+      limb += borrow << 32;
+      difference.limbs[k] = static_cast<std::uint32_t>(limb);
+    }
+    return difference;
+  }
+
+  static FixedPoint signed_sum(const FixedPoint &a, const FixedPoint &b,
+                               const bool &b_negative) {
+    // a + b with the sign of b replaced by b_negative
+    FixedPoint sum;
+    if (a.negative == b_negative) {
+      sum = add_magnitudes(a, b);
+      sum.negative = a.negative;
+    } else if (compare_magnitude(a, b) >= 0) {
+      sum = subtract_magnitudes(a, b);
+      sum.negative = a.negative;
+    } else {
+      sum = subtract_magnitudes(b, a);
+      sum.negative = b_negative;
+    }
+    sum.normalize();
+    return sum;
+  }
+
+  void normalize() {
+    // zero is positive
+    if (negative && is_zero()) {
+      negative = false;
+    }
+  }
+
+  void add_shifted(const std::uint64_t &value, const int &shift) {
+    // adds value 2**shift to the magnitude, in units of the last limb
+    const int limb = shift / 32;
+    const int bit = shift % 32;
+    const std::uint64_t parts[2] = {value & 0xffffffffu, value >> 32};
+    for (int p = 0; p < 2; ++p) {
+      std::uint64_t carry = parts[p] << bit;
+      for (int k = limb + p; k < Limbs && carry != 0; ++k) {
+        carry += limbs[k];
+        limbs[k] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+      }
+    }
+  }
+
+public:
+  FixedPoint() = default;
+
+  FixedPoint(const double &value) : FixedPoint(value, 0) {}
+
+  FixedPoint(const double &value, const int &scale_exponent) {
+    /*
+      value 2**scale_exponent, to take numbers out of the range of double
+      exact for |value 2**scale_exponent| < 2**31 when its bits below
+      2**-(32 (Limbs - 1)) are zero, truncated towards zero otherwise
+    */
+    if (value == 0.0 || !std::isfinite(value)) {
+      return;
+    }
+    int exponent;
+    const double mantissa = std::frexp(std::abs(value), &exponent);
+    // |value| = bits 2**(exponent - 53), bits < 2**53
+    std::uint64_t bits =
+        static_cast<std::uint64_t>(std::ldexp(mantissa, 53));
+    int shift = exponent + scale_exponent - 53 + 32 * (Limbs - 1);
+    if (shift < 0) {
+      bits = -shift < 64 ? bits >> -shift : 0;
+      shift = 0;
+    }
+    add_shifted(bits, shift);
+    negative = value < 0;
+    normalize();
+  }
+
+  explicit operator double() const {
+    // rounds the three most significant nonzero limbs, enough for a double
+    int top = Limbs - 1;
+    while (top >= 0 && limbs[top] == 0) {
+      top -= 1;
+    }
+    double value = 0.0;
+    for (int k = top; k >= 0 && k > top - 3; --k) {
+      value +=
+          std::ldexp(static_cast<double>(limbs[k]), 32 * (k - Limbs + 1));
+    }
+    return negative ? -value : value;
+  }
+
+  bool is_zero() const {
+    for (const std::uint32_t &limb : limbs) {
+      if (limb != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  FixedPoint operator-() const {
+    FixedPoint opposite = *this;
+    opposite.negative = !negative;
+    opposite.normalize();
+    return opposite;
+  }
+
+  friend FixedPoint operator+(const FixedPoint &a, const FixedPoint &b) {
+    return signed_sum(a, b, b.negative);
+  }
+
+  friend FixedPoint operator-(const FixedPoint &a, const FixedPoint &b) {
+    return signed_sum(a, b, !b.negative);
+  }
+
+  friend FixedPoint operator*(const FixedPoint &a, const FixedPoint &b) {
+    /*
+      schoolbook product of the magnitudes, truncated: the 2 Limbs limb
+      product is shifted down by Limbs - 1 limbs and the partial products
+      below the limb under the last one kept are never computed, so the
+      result is at most Limbs units of the last limb below the exact one
+    */
+    std::array<std::uint32_t, 2 * Limbs> product = {};
+    for (int i = 0; i < Limbs; ++i) {
+      std::uint64_t carry = 0;
+      for (int j = std::max(0, Limbs - 2 - i); j < Limbs; ++j) {
+        const std::uint64_t limb =
+            static_cast<std::uint64_t>(a.limbs[i]) * b.limbs[j] +
+            product[i + j] + carry;
+        product[i + j] = static_cast<std::uint32_t>(limb);
+        carry = limb >> 32;
+      }
+      product[i + Limbs] = static_cast<std::uint32_t>(carry);
+    }
+    FixedPoint result;
+    for (int k = 0; k < Limbs; ++k) {
+      result.limbs[k] = product[k + Limbs - 1];
+    }
+    result.negative = a.negative != b.negative;
+    result.normalize();
+    return result;
+  }
+
+  FixedPoint square() const {
+    /*
+      same as *this * *this with about half the partial products: the ones
+      off the diagonal are computed once and doubled
+    */
+    std::array<std::uint32_t, 2 * Limbs> product = {};
+    for (int i = 0; i < Limbs; ++i) {
+      std::uint64_t carry = 0;
+      for (int j = std::max(i + 1, Limbs - 2 - i); j < Limbs; ++j) {
+        const std::uint64_t limb =
+            static_cast<std::uint64_t>(limbs[i]) * limbs[j] + product[i + j] +
+            carry;
+        product[i + j] = static_cast<std::uint32_t>(limb);
+        carry = limb >> 32;
+      }
+      product[i + Limbs] = static_cast<std::uint32_t>(carry);
+    }
+    std::uint32_t shifted_out = 0;
+    for (int k = 0; k < 2 * Limbs; ++k) {
+      const std::uint32_t top_bit = product[k] >> 31;
+      product[k] = (product[k] << 1) | shifted_out;
+      shifted_out = top_bit;
+    }
+    std::uint64_t carry = 0;
+    for (int k = 0; k < 2 * Limbs; ++k) {
+      std::uint64_t limb = static_cast<std::uint64_t>(product[k]) + carry;
+      if (k % 2 == 0 && k >= Limbs - 2) {
+        limb += static_cast<std::uint64_t>(limbs[k / 2]) * limbs[k / 2];
+      }
+      product[k] = static_cast<std::uint32_t>(limb);
+      carry = limb >> 32;
+    }
+    FixedPoint result;
+    for (int k = 0; k < Limbs; ++k) {
+      result.limbs[k] = product[k + Limbs - 1];
+    }
+    return result;
+  }
+
+  friend bool operator==(const FixedPoint &a, const FixedPoint &b) {
+    return a.negative == b.negative && compare_magnitude(a, b) == 0;
+  }
+
+  friend bool operator!=(const FixedPoint &a, const FixedPoint &b) {
+    return !(a == b);
+  }
+
+  friend bool operator<(const FixedPoint &a, const FixedPoint &b) {
+    if (a.negative != b.negative) {
+      return a.negative;
+    }
+    const int magnitude = compare_magnitude(a, b);
+    return a.negative ? magnitude > 0 : magnitude < 0;
+  }
+
+  friend bool operator>(const FixedPoint &a, const FixedPoint &b) {
+    return b < a;
+  }
+
+  friend bool operator<=(const FixedPoint &a, const FixedPoint &b) {
+    return !(b < a);
+  }
+
+  friend bool operator>=(const FixedPoint &a, const FixedPoint &b) {
+    return !(a < b);
+  }
+};
+
+template <int Limbs>
+bool fixed_step(FixedPoint<Limbs> &z_real, FixedPoint<Limbs> &z_im,
+                const FixedPoint<Limbs> &c_real,
+                const FixedPoint<Limbs> &c_im) {
+  /*
+    one iteration of z = z**2 + c with three squarings and no product:
+      real = x**2 - y**2 + c_real, im = (x + y)**2 - x**2 - y**2 + c_im
+    the squares of x and y also give |z|**2 for free
+
+    returns false, leaving z as it is, if |z|**2 >= 4 (z escaped)
+  */
+  const FixedPoint<Limbs> x2 = z_real.square();
+  const FixedPoint<Limbs> y2 = z_im.square();
+  const FixedPoint<Limbs> norm = x2 + y2;
+  if (norm >= FixedPoint<Limbs>(4.0)) {
+    return false;
+  }
+  z_im = (z_real + z_im).square() - norm + c_im;
+  z_real = x2 - y2 + c_real;
+  return true;
+}
+
+template <int Limbs>
+int num_iter_fixed(const FixedPoint<Limbs> &c_real,
+                   const FixedPoint<Limbs> &c_im, const int &max_iter) {
+  /*
+    same as num_iter(0, c, max_iter) in fixed point: slow, but exact to the
+    last limb for points double can not tell apart, to verify deep zooms
+  */
+  FixedPoint<Limbs> z_real;
+  FixedPoint<Limbs> z_im;
+  int it = 0;
+  while (it < max_iter && fixed_step(z_real, z_im, c_real, c_im)) {
+    it += 1;
+  }
+  return it;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+// Floating point numbers with a double mantissa and a separate int exponent,
+// value = mantissa 2**exponent with 0.5 <= |mantissa| < 1 (or mantissa 0):
+// the precision of double with a range far beyond 1e-308, for the scaling
+// factors and the pixel deltas of extreme deep zooms. Normalizing and adding
+// read and write the exponent bits of the mantissa directly instead of
+// calling frexp / ldexp, so that loops multiplying or adding arrays of
+// FloatExp have no calls and no branches and the compiler can vectorize them.
+// Infinities and NaN are kept as they are (with exponent 0), so that an
+// overflow propagates as in double
+
+class FloatExp {
+private:
+  double mantissa = 0.0;
+  int exponent = 0;
+
+  static int exponent_bits(const double &value) {
+    // biased exponent of a double, 0 for zero and subnormals
+    std::uint64_t raw;
+    std::memcpy(&raw, &value, sizeof(raw));
+    return static_cast<int>((raw >> 52) & 0x7ff);
+  }
+
+  static double with_exponent_bits(const double &value, const int &bits) {
+    // value with its exponent bits replaced
+    std::uint64_t raw;
+    std::memcpy(&raw, &value, sizeof(raw));
+    raw = (raw & ~(std::uint64_t(0x7ff) << 52)) |
+          (static_cast<std::uint64_t>(bits) << 52);
+    double replaced;
+    std::memcpy(&replaced, &raw, sizeof(replaced));
+    return replaced;
+  }
+
+  void normalize() {
+    /*
+      brings a normal nonzero mantissa back to 0.5 <= |mantissa| < 1, leaves
+      infinities and NaN as they are
+    */
+    const int bits = exponent_bits(mantissa);
+    const bool zero = bits == 0;
+    const bool finite = bits != 0x7ff;
+    exponent = zero || !finite ? 0 : exponent + bits - 1022;
+    mantissa = zero     ? 0.0
+               : finite ? with_exponent_bits(mantissa, 1022)
+                        : mantissa;
+  }
+
+  int magnitude() const {
+    /*
+      exponent for the alignment of a sum: zero below every number, so that
+      it is the one scaled, infinities and NaN above, so that they are not
+    */
+    const int bits = exponent_bits(mantissa);
+    return bits == 0 ? -(1 << 30) : bits == 0x7ff ? (1 << 30) : exponent;
+  }
+
+public:
+  FloatExp() = default;
+
+  FloatExp(const double &value) : mantissa(value), exponent(0) {
+    /*
+      subnormal doubles (below 2.2e-308) are taken as zero
+    */
+    normalize();
+  }
+
+  FloatExp(const double &mantissa, const int &exponent)
+      : mantissa(mantissa), exponent(exponent) {
+    // mantissa 2**exponent
+    normalize();
+  }
+
+  double getMantissa() const { return mantissa; }
+  int getExponent() const { return exponent; }
+
+  explicit operator double() const {
+    // 0 or infinity out of the range of double
+    return std::ldexp(mantissa, exponent);
+  }
+
+  double scaled(const int &scale_exponent) const {
+    // the value in units of 2**scale_exponent, as a double
+    return std::ldexp(mantissa, exponent - scale_exponent);
+  }
+
+  double log10() const {
+    // decimal logarithm of |value|, for values out of the range of double
+    return std::log10(std::abs(mantissa)) + exponent * std::log10(2.0);
+  }
+
+  friend FloatExp operator*(const FloatExp &a, const FloatExp &b) {
+    return FloatExp(a.mantissa * b.mantissa, a.exponent + b.exponent);
+  }
+
+  friend FloatExp operator/(const FloatExp &a, const FloatExp &b) {
+    return FloatExp(a.mantissa / b.mantissa, a.exponent - b.exponent);
+  }
+
+  friend FloatExp operator+(const FloatExp &a, const FloatExp &b) {
+    /*
+      the operand with the smaller exponent is scaled to the other one by
+      rewriting its exponent bits; one more than 2**1021 times smaller, or
+      zero, adds nothing to a mantissa of 53 bits and is dropped
+    */
+    const bool a_larger = a.magnitude() >= b.magnitude();
+    const FloatExp &larger = a_larger ? a : b;
+    const FloatExp &smaller = a_larger ? b : a;
+    const int shift = smaller.magnitude() - larger.magnitude();
+    const bool finite = exponent_bits(smaller.mantissa) != 0x7ff;
+    const double scaled =
+        !finite      ? smaller.mantissa
+        : shift < -1021 ? 0.0
+                        : with_exponent_bits(smaller.mantissa,
+                                             1022 + std::max(shift, -1021));
+    return FloatExp(larger.mantissa + scaled, larger.exponent);
+  }
+
+  friend FloatExp operator-(const FloatExp &a) {
+    FloatExp opposite = a;
+    opposite.mantissa = -a.mantissa;
+    return opposite;
+  }
+
+  friend FloatExp operator-(const FloatExp &a, const FloatExp &b) {
+    return a + -b;
+  }
+
+  friend bool operator<(const FloatExp &a, const FloatExp &b) {
+    return (a - b).mantissa < 0.0;
+  }
+
+  friend bool operator>(const FloatExp &a, const FloatExp &b) { return b < a; }
+
+  friend bool operator<=(const FloatExp &a, const FloatExp &b) {
+    return !(b < a);
+  }
+
+  friend bool operator>=(const FloatExp &a, const FloatExp &b) {
+    return !(a < b);
+  }
+
+  friend bool operator==(const FloatExp &a, const FloatExp &b) {
+    return a.mantissa == b.mantissa && a.exponent == b.exponent;
+  }
+};
+
+std::string scientific(const FloatExp &value, const int &precision = 6) {
+  /*
+    value in scientific notation like std::scientific, also out of the range
+    of double
+  */
+  std::ostringstream text;
+  if (value.getMantissa() == 0.0 || !std::isfinite(value.getMantissa())) {
+    text << std::scientific << std::setprecision(precision)
+         << value.getMantissa();
+    return text.str();
+  }
+  const double log = value.log10();
+  int decimal_exponent = static_cast<int>(std::floor(log));
+  double digits = std::pow(10.0, log - decimal_exponent);
+  // rounding to precision digits may carry into a new one (9.9999999)
+  if (std::round(digits * std::pow(10.0, precision)) >=
+      std::pow(10.0, precision + 1)) {
+    digits /= 10.0;
+    decimal_exponent += 1;
+  }
+  text << (value.getMantissa() < 0 ? "-" : "") << std::fixed
+       << std::setprecision(precision) << digits << "e"
+       << (decimal_exponent < 0 ? "-" : "+") << std::setw(2)
+       << std::setfill('0') << std::abs(decimal_exponent);
+  return text.str();
+}
@@ -1,10 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <complex>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "deep_zoom.h"
+#include "doubledouble.h"
+#include "floatexp.h"
+#include "thread_pool.h"
+
+// default amount of memory the sequence renderers may spend on boards that are
+// rendered but not yet written to disk
+const std::size_t default_memory_budget = 256 * 1024 * 1024;
+
+// iterations after which a point of a board is considered bounded
+const int board_max_iterations = 300;
+
+// side of the square tiles of a LazyFrame, rendered the first time one of
+// their pixels is read
+const int lazy_tile = 32;
+
+// number of complex constants iterated together by the batch julia kernel
+const int julia_batch_lanes = 4;
+
+// number of pixels iterated together by the double-double and float kernels
+const int double_double_lanes = 4;
+const int float_lanes = 8;
+
+// number of scattered points iterated together by batch_num_iter, and points
+// per job of the shared pool when it runs in parallel
+const int point_lanes = 4;
+const int point_batch = 4096;
+
+// independent randomly shifted point sets of a mandelbrot_area estimate, whose
+// spread gives its confidence interval, and samples per job of the estimate
+const int area_replicates = 16;
+const int area_job = 65536;
+
+// precision ladder of the zoom sequences (see mandelbrot_engine): smallest
+// pixel spacing each escape time engine resolves, and most iterations float
+// and double-double are trusted with, rounding errors growing with them
+// (past them perturbation is also cheaper than double-double)
+const double float_spacing = 1e-4;
+const double double_spacing = 1e-12;
+const double double_double_spacing = 1e-28;
+const int float_max_iterations = 1000;
+const int double_double_max_iterations = 5000;
+
 int num_iter(std::complex<double> z0, std::complex<double> c, int max_iter,
              double thresh = 4) {
   /*
@@ -25,6 +83,461 @@ int num_iter(std::complex<double> z0, std::complex<double> c, int max_iter,
   return it;
 }
 
+int num_iter_periodic(std::complex<double> z0, std::complex<double> c,
+                      int max_iter, double thresh = 4) {
+  /*
+    same as num_iter, but the orbit is compared with a point saved at every
+    power of two iterations: when it comes back exactly on it the orbit is a
+    cycle that never diverges, so max_iter is returned without iterating any
+    further. Since the comparison is exact the result is always the same of
+    num_iter, points inside an attracting cycle basin just get there sooner
+  */
+  std::complex<double> zn = std::move(z0);
+  std::complex<double> saved = zn;
+  int next_save = 1;
+  int it = 0;
+  while ((std::norm(zn) < thresh) && it < max_iter) {
+    zn = zn * zn + c;
+    it += 1;
+    if (zn == saved) {
+      return max_iter;
+    }
+    if (it == next_save) {
+      saved = zn;
+      next_save *= 2;
+    }
+  }
+  return it;
+}
+
+enum class JuliaKind {
+  disconnected, // the critical orbit escapes, the julia set is dust
+  attracting,   // the critical orbit falls in an attracting cycle
+  bounded // the critical orbit stays bounded without settling on a cycle
+};
+
+struct JuliaClassification {
+  // what the orbit of the critical point 0 tells about a julia set
+  JuliaKind kind;
+  int escape_iteration;   // when the critical orbit diverged, -1 if it did not
+  int period;             // period of the attracting cycle, 0 if none
+  bool check_periodicity; // render with cycle detection (num_iter_periodic)
+};
+
+JuliaClassification classify_julia(const std::complex<double> &c,
+                                   int max_iter = 16 * board_max_iterations) {
+  /*
+    iterates the critical point 0 under z = z**2 + c: J(c) is connected if and
+    only if its orbit stays bounded. Since this costs as much as a handful of
+    pixels it is done before rendering to choose how to render:
+    - disconnected: the filled julia set has no interior, every pixel escapes
+      and looking for cycles would only slow the iterations down
+    - attracting: the interior pixels are attracted by the same cycle of the
+      critical point, detecting the cycle stops them long before max_iter
+    - bounded: no cycle showed up (parabolic or nearly so), the interior
+      converges too slowly for cycle detection to pay off
+    max_iter: iterations given to the critical orbit
+  */
+  std::complex<double> z = 0.0;
+  for (int it = 0; it < max_iter; ++it) {
+    if (std::norm(z) >= 4) {
+      return {JuliaKind::disconnected, it, 0, false};
+    }
+    z = z * z + c;
+  }
+  // z is now next to the limit of the critical orbit, a cycle through it is
+  // attracting if the product of the derivatives along it is less than one
+  const int max_period = 1024;
+  std::complex<double> w = z;
+  std::complex<double> multiplier = 1.0;
+  for (int period = 1; period <= max_period; ++period) {
+    multiplier *= 2.0 * w;
+    w = w * w + c;
+    if (std::abs(w - z) < 1e-10) {
+      if (std::abs(multiplier) < 1.0) {
+        return {JuliaKind::attracting, -1, period, true};
+      }
+      break;
+    }
+  }
+  return {JuliaKind::bounded, -1, 0, false};
+}
+
+template <int Lanes>
+void num_iter_lanes(const std::complex<double> &z0, const double *c_real,
+                    const double *c_im, int *iterations, const int &max_iter,
+                    double thresh = 4, const bool *check_period = nullptr) {
+  /*
+    same as num_iter for one starting point z0 and Lanes complex constants at
+    once, the constants live in the lanes of the arrays so that the compiler
+    can keep every lane in one SIMD register and iterate them together
+    c_real, c_im: real and imaginary parts of the Lanes constants
+    iterations: receives the Lanes numbers of iterations
+    check_period: lanes stopped as in num_iter_periodic when their orbit comes
+    back on itself, none if nullptr
+
+    the arithmetic is the same of std::complex, so the counts are identical to
+    the ones of num_iter
+  */
+  double zr[Lanes];
+  double zi[Lanes];
+  double saved_r[Lanes];
+  double saved_i[Lanes];
+  bool watch[Lanes];
+  int it[Lanes];
+  for (int l = 0; l < Lanes; ++l) {
+    zr[l] = z0.real();
+    zi[l] = z0.imag();
+    saved_r[l] = zr[l];
+    saved_i[l] = zi[l];
+    watch[l] = check_period != nullptr && check_period[l];
+    it[l] = 0;
+  }
+  int next_save = 1;
+  for (int n = 0; n < max_iter; ++n) {
+    int running = 0;
+    for (int l = 0; l < Lanes; ++l) {
+      const double zr2 = zr[l] * zr[l];
+      const double zi2 = zi[l] * zi[l];
+      const bool inside = zr2 + zi2 < thresh && it[l] < max_iter;
+      const double next_r = zr2 - zi2 + c_real[l];
+      const double next_i = zr[l] * zi[l] + zi[l] * zr[l] + c_im[l];
+      const bool cycled = inside && watch[l] && next_r == saved_r[l] &&
+                          next_i == saved_i[l];
+      zr[l] = inside ? next_r : zr[l];
+      zi[l] = inside ? next_i : zi[l];
+      it[l] = cycled ? max_iter : it[l] + inside;
+      running += inside && !cycled;
+    }
+    if (running == 0) {
+      break;
+    }
+    if (n + 1 == next_save) {
+      for (int l = 0; l < Lanes; ++l) {
+        saved_r[l] = zr[l];
+        saved_i[l] = zi[l];
+      }
+      next_save *= 2;
+    }
+  }
+  for (int l = 0; l < Lanes; ++l) {
+    iterations[l] = it[l];
+  }
+}
+
+template <int Lanes>
+void num_iter_points_lanes(const double *real, const double *im,
+                           const std::size_t *points, const std::size_t &count,
+                           int *iterations, const int &max_iter,
+                           const std::complex<double> &c = 0.0,
+                           const bool &mandel_or_julia = true,
+                           const bool &check_period = false) {
+  /*
+    same as num_iter for the count points real[points[k]] + i im[points[k]],
+    the constants of the mandelbrot set iterated from 0 or the starting points
+    of the julia set of c; Lanes points are iterated together in plain arrays
+    as in num_iter_lanes, and a lane whose point is done takes the next one at
+    once, so that scattered points do not wait for the slowest of their lanes
+    iterations: receives the numbers of iterations at the indices points[k]
+    check_period: stop the orbits coming back on themselves as in
+    num_iter_periodic, with a save schedule for each lane
+
+    the arithmetic is the same of std::complex, so the counts are identical to
+    the ones of num_iter (num_iter_periodic with check_period)
+  */
+  double zr[Lanes], zi[Lanes], cr[Lanes], ci[Lanes];
+  double saved_r[Lanes], saved_i[Lanes];
+  int it[Lanes], next_save[Lanes];
+  std::size_t point[Lanes];
+  std::size_t next = 0;
+  int busy = 0;
+  auto load = [&](const int &l) {
+    // the next point in lane l, or an idle lane when there is none left
+    if (next == count) {
+      point[l] = count;
+      zr[l] = zi[l] = 2.0; // escaped, never iterated
+      cr[l] = ci[l] = 0.0;
+      return;
+    }
+    point[l] = next;
+    const std::size_t k = points[next++];
+    zr[l] = mandel_or_julia ? 0.0 : real[k];
+    zi[l] = mandel_or_julia ? 0.0 : im[k];
+    cr[l] = mandel_or_julia ? real[k] : c.real();
+    ci[l] = mandel_or_julia ? im[k] : c.imag();
+    saved_r[l] = zr[l];
+    saved_i[l] = zi[l];
+    it[l] = 0;
+    next_save[l] = 1;
+    busy += 1;
+  };
+  for (int l = 0; l < Lanes; ++l) {
+    load(l);
+  }
+  while (busy > 0) {
+    int finished = 0;
+    for (int l = 0; l < Lanes; ++l) {
+      const double zr2 = zr[l] * zr[l];
+      const double zi2 = zi[l] * zi[l];
+      const bool inside = zr2 + zi2 < 4.0 && it[l] < max_iter;
+      const double next_r = zr2 - zi2 + cr[l];
+      const double next_i = zr[l] * zi[l] + zi[l] * zr[l] + ci[l];
+      const bool cycled = inside && check_period && next_r == saved_r[l] &&
+                          next_i == saved_i[l];
+      zr[l] = inside ? next_r : zr[l];
+      zi[l] = inside ? next_i : zi[l];
+      it[l] = cycled ? max_iter : it[l] + inside;
+      const bool save = inside && it[l] == next_save[l];
+      saved_r[l] = save ? zr[l] : saved_r[l];
+      saved_i[l] = save ? zi[l] : saved_i[l];
+      next_save[l] = save ? 2 * next_save[l] : next_save[l];
+      finished += !inside || cycled;
+    }
+    if (finished == 0) {
+      continue;
+    }
+    for (int l = 0; l < Lanes; ++l) {
+      const bool done =
+          zr[l] * zr[l] + zi[l] * zi[l] >= 4.0 || it[l] >= max_iter;
+      if (point[l] < count && done) {
+        iterations[points[point[l]]] = it[l];
+        busy -= 1;
+        load(l);
+      }
+    }
+  }
+}
+
+bool in_cardioid_or_bulb(const double &c_real, const double &c_im) {
+  /*
+    c is in the main cardioid or in the period 2 bulb of the mandelbrot set,
+    where the orbit of 0 is attracted by a fixed point or a 2-cycle and never
+    escapes: a few operations instead of max_iter iterations
+  */
+  const double x = c_real - 0.25;
+  const double y2 = c_im * c_im;
+  const double q = x * x + y2;
+  return q * (q + x) <= 0.25 * y2 ||
+         (c_real + 1.0) * (c_real + 1.0) + y2 <= 0.0625;
+}
+
+struct PointQuery {
+  // how batch_num_iter iterates its points
+  std::complex<double> c = 0.0; // constant of the julia set
+  bool mandel_or_julia = true;  // mandelbrot constants, or julia points
+  bool check_period = false;    // cycle detection (num_iter_periodic)
+  bool skip_cardioid = false;   // max_iter for in_cardioid_or_bulb points
+  bool parallel = true;         // batches on the shared pool
+};
+
+void batch_num_iter(const double *real, const double *im, int *iterations,
+                    const std::size_t &count, const int &max_iter,
+                    const PointQuery &query = PointQuery()) {
+  /*
+    escape times of count scattered points, point_lanes at a time
+    (num_iter_points_lanes): for the mandelbrot set the point k is the
+    constant real[k] + i im[k] iterated from 0, for a julia set it is the
+    starting point iterated with query.c
+    iterations: receives the count numbers of iterations, the same of num_iter
+    (num_iter_periodic with query.check_period)
+    query.skip_cardioid: mandelbrot points in the main cardioid or the period
+    2 bulb (in_cardioid_or_bulb) get max_iter without iterating, which their
+    orbits would reach anyway but for rounding right on the boundary
+    query.parallel: split the points among the shared pool, point_batch per
+    job; from a job of the pool the query must be serial
+  */
+  const std::complex<double> &c = query.c;
+  const bool &mandel_or_julia = query.mandel_or_julia;
+  auto run_batch = [&](const int &batch) {
+    const std::size_t first = static_cast<std::size_t>(batch) * point_batch;
+    const std::size_t last =
+        std::min(count, first + static_cast<std::size_t>(point_batch));
+    // the points left to iterate, the others being already known
+    std::vector<std::size_t> pending;
+    pending.reserve(last - first);
+    for (std::size_t k = first; k < last; ++k) {
+      if (mandel_or_julia && query.skip_cardioid &&
+          in_cardioid_or_bulb(real[k], im[k])) {
+        iterations[k] = max_iter;
+      } else {
+        pending.push_back(k);
+      }
+    }
+    num_iter_points_lanes<point_lanes>(real, im, pending.data(),
+                                       pending.size(), iterations, max_iter,
+                                       c, mandel_or_julia,
+                                       query.check_period);
+  };
+  const int num_batches =
+      static_cast<int>((count + point_batch - 1) / point_batch);
+  if (query.parallel) {
+    parallel_jobs(num_batches, run_batch);
+  } else {
+    for (int batch = 0; batch < num_batches; ++batch) {
+      run_batch(batch);
+    }
+  }
+}
+
+struct AreaEstimate {
+  // Monte Carlo estimate of the area of the mandelbrot set in a rectangle
+  std::uint64_t samples;     // points iterated, in all the replicates
+  double area;               // mean of the replicate estimates
+  double standard_error;     // of the mean, from the spread of the replicates
+  double low;                // 95% confidence interval of the area
+  double high;
+  std::vector<std::uint64_t> histogram; // samples by escape time, the last
+                                        // bin (max_iter) holds the inside ones
+  double seconds;            // time spent
+  double samples_per_second; // throughput
+
+  double inside_fraction() const {
+    return samples == 0 ? 0.0
+                        : static_cast<double>(histogram.back()) / samples;
+  }
+};
+
+AreaEstimate mandelbrot_area(const double &real_min, const double &real_max,
+                             const double &im_min, const double &im_max,
+                             const std::uint64_t &samples, const int &max_iter,
+                             const std::uint64_t &seed = 0,
+                             const int &replicates = area_replicates,
+                             const bool &parallel = false) {
+  /*
+    estimates the area of the mandelbrot set in the rectangle, taking the
+    points still bounded after max_iter iterations as inside: the estimate
+    converges to the area of that superset, which shrinks towards the set as
+    max_iter grows
+
+    the samples are split among replicates copies of the R2 quasi-random
+    sequence (Roberts, the plastic number generalization of the golden ratio),
+    each shifted by a random offset drawn from seed: every replicate is an
+    unbiased estimate with the low discrepancy of the sequence, and their
+    spread gives the standard error (randomized quasi Monte Carlo)
+    the sequence runs in 64 bit fixed point, so it keeps its resolution over
+    billions of samples
+
+    the points are iterated by batch_num_iter with cycle detection and the
+    cardioid shortcut; each job of area_job samples counts in a tally of its
+    own, and the tallies are merged in job order, so the result only depends
+    on the arguments, whatever the number of threads
+    parallel: run the jobs on the shared pool, not from a job of the pool
+  */
+  const auto start = std::chrono::steady_clock::now();
+  const int num_replicates = std::max(replicates, 2);
+  const std::uint64_t per_replicate =
+      (samples + num_replicates - 1) / num_replicates;
+  const int jobs_per_replicate =
+      static_cast<int>((per_replicate + area_job - 1) / area_job);
+  // R2 steps 1 / g and 1 / g**2 in units of 2**-64, g**3 = g + 1
+  const std::uint64_t step_real = 0xc13fa9a902a6328fULL;
+  const std::uint64_t step_im = 0x91e10da5c79e7b1dULL;
+  auto shift = [&](const std::uint64_t &stream) {
+    // splitmix64, the offsets of a replicate
+    std::uint64_t z = seed + (stream + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  };
+  auto unit = [](const std::uint64_t &fraction) {
+    // the top 53 bits of a fraction of 2**64, in [0, 1)
+    return std::ldexp(static_cast<double>(fraction >> 11), -53);
+  };
+
+  struct Tally {
+    std::uint64_t inside = 0;
+    std::vector<std::uint64_t> histogram;
+  };
+  auto job = [&](const int &index) {
+    const int replicate = index / jobs_per_replicate;
+    const std::uint64_t first =
+        static_cast<std::uint64_t>(index % jobs_per_replicate) * area_job;
+    const std::uint64_t last =
+        std::min(per_replicate, first + static_cast<std::uint64_t>(area_job));
+    const std::uint64_t shift_real = shift(2 * replicate);
+    const std::uint64_t shift_im = shift(2 * replicate + 1);
+    Tally tally;
+    tally.histogram.assign(max_iter + 1, 0);
+    std::vector<double> real(point_batch);
+    std::vector<double> im(point_batch);
+    std::vector<int> iterations(point_batch);
+    for (std::uint64_t n = first; n < last; n += point_batch) {
+      const std::size_t count =
+          std::min<std::uint64_t>(point_batch, last - n);
+      for (std::size_t k = 0; k < count; ++k) {
+        const std::uint64_t sample = n + k;
+        real[k] = real_min + (real_max - real_min) *
+                                 unit(shift_real + sample * step_real);
+        im[k] = im_min + (im_max - im_min) * unit(shift_im + sample * step_im);
+      }
+      PointQuery query;
+      query.check_period = true;
+      query.skip_cardioid = true;
+      // the estimate is already split among the jobs of the pool
+      query.parallel = false;
+      batch_num_iter(real.data(), im.data(), iterations.data(), count,
+                     max_iter, query);
+      for (std::size_t k = 0; k < count; ++k) {
+        tally.histogram[iterations[k]] += 1;
+      }
+    }
+    tally.inside = tally.histogram[max_iter];
+    return tally;
+  };
+
+  AreaEstimate estimate;
+  estimate.samples = per_replicate * num_replicates;
+  estimate.histogram.assign(max_iter + 1, 0);
+  std::vector<std::uint64_t> inside(num_replicates, 0);
+  auto merge = [&](const int &index, Tally tally) {
+    inside[index / jobs_per_replicate] += tally.inside;
+    for (int it = 0; it <= max_iter; ++it) {
+      estimate.histogram[it] += tally.histogram[it];
+    }
+  };
+  const int num_jobs = num_replicates * jobs_per_replicate;
+  if (parallel) {
+    ordered_parallel_jobs(
+        num_jobs,
+        jobs_in_flight(default_memory_budget,
+                       (max_iter + 1) * sizeof(std::uint64_t)),
+        job, merge);
+  } else {
+    for (int index = 0; index < num_jobs; ++index) {
+      merge(index, job(index));
+    }
+  }
+
+  const double rectangle = (real_max - real_min) * (im_max - im_min);
+  double sum = 0.0;
+  double sum_squares = 0.0;
+  for (const std::uint64_t &count : inside) {
+    const double area =
+        per_replicate == 0 ? 0.0 : rectangle * count / per_replicate;
+    sum += area;
+    sum_squares += area * area;
+  }
+  estimate.area = sum / num_replicates;
+  const double variance =
+      std::max(0.0, (sum_squares - sum * estimate.area) / (num_replicates - 1));
+  estimate.standard_error = std::sqrt(variance / num_replicates);
+  // 97.5% quantile of Student's t with num_replicates - 1 degrees of freedom,
+  // Cornish-Fisher expansion around the normal one: 2.131 for 16 replicates
+  const double z = 1.959964;
+  const double dof = num_replicates - 1;
+  const double t = z + (z * z * z + z) / (4 * dof) +
+                   (5 * std::pow(z, 5) + 16 * z * z * z + 3 * z) /
+                       (96 * dof * dof);
+  estimate.low = estimate.area - t * estimate.standard_error;
+  estimate.high = estimate.area + t * estimate.standard_error;
+  estimate.seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  estimate.samples_per_second =
+      estimate.seconds > 0.0 ? estimate.samples / estimate.seconds : 0.0;
+  return estimate;
+}
+
 const std::string smkdir(const std::string &name) {
   /*
     smart mkdir works on multiple cases:
@@ -44,11 +557,41 @@ const std::string smkdir(const std::string &name) {
   return name;
 }
 
+struct Viewport {
+  /*
+    frame of a board rendered in double, to render parts of it again: the
+    pixel (x, y) is at
+      (x + pan_x) z_real_bound + corner_real + i ((y + pan_y) z_im_bound +
+      corner_im)
+    as in fill_board, the integer pan offsets keeping the pixels of a panned
+    board on the points of the board it was panned from
+  */
+  double z_real_bound = 0.0;
+  double z_im_bound = 0.0;
+  double corner_real = 0.0;
+  double corner_im = 0.0;
+  std::complex<double> c = 0.0;
+  bool mandel_or_julia = true;
+  bool check_period = false;
+  int max_iterations = board_max_iterations;
+  int pan_x = 0;
+  int pan_y = 0;
+  bool valid = false; // false for boards not rendered in double
+};
+
+struct ProgressivePass {
+  // how far a progressive render went (see Fractals::progressive_gen)
+  int block;        // blocks of the finest complete pass, 1 for exact pixels
+  int rendered;     // pixels iterated so far
+  bool interrupted; // the deadline or the cancellation stopped the render
+};
+
 class Fractals {
   // Mother class containing useful methods and attributes for fractals rendering
 private:
   int dim; // dimension of the image
   std::vector<double> board; // vector rapresenting the pixels of the images
+  Viewport viewport;         // frame of the board, if rendered in double
 public:
   Fractals(int dim) : dim(dim), board(dim * dim, 1.0) {}
   int getDimension() const { return dim; }
@@ -67,21 +610,302 @@ public:
       of 0 in the imaginary axis) c: complex constant to generate julia set
       mandel_or_julia: 0 -> generates mandelbrot set, 1 -> generates julia set
      */
-    const int max_iterations = 300;
-    for (int x = 0; x < this->dim; ++x) {
-      for (int y = 0; y < this->dim; ++y) {
-        double real = x * z_real_bound + center_real;
-        double im = y * z_im_bound + center_im;
+    fill_board(this->board, this->dim, z_real_bound, z_im_bound, center_real,
+               center_im, c, mandel_or_julia);
+    setViewport({z_real_bound, z_im_bound, center_real, center_im, c,
+                 mandel_or_julia});
+  }
+
+  void board_gen(const double &z_real_bound, const double &z_im_bound,
+                 const DoubleDouble &center_real, const DoubleDouble &center_im,
+                 std::complex<double> c = std::complex<double>(0.0, 0.0),
+                 bool mandel_or_julia = true) {
+    /*
+      same as board_gen with the pixel coordinates and the iterations in
+      double-double, for frames double can not resolve (scaling factors
+      between about 1e-13 and 1e-28)
+     */
+    fill_board(this->board, this->dim, z_real_bound, z_im_bound, center_real,
+               center_im, c, mandel_or_julia);
+    viewport = Viewport();
+  }
+
+  ProgressivePass progressive_gen(
+      const double &z_real_bound, const double &z_im_bound,
+      const double &center_real, const double &center_im,
+      const std::complex<double> &c, const bool &mandel_or_julia,
+      const std::chrono::steady_clock::time_point &deadline,
+      const std::atomic<bool> *cancel = nullptr,
+      const std::function<void(const ProgressivePass &)> &on_pass = nullptr,
+      const int &first_block = 16) {
+    /*
+      same as board_gen within a time budget: a first pass iterates one
+      pixel per first_block x first_block block and fills the block with it,
+      then each pass halves the blocks, iterating only the pixels the
+      previous passes did not, down to single pixels; the blocks of a pass go
+      from the center of the board outwards, ring after ring, so that an
+      interrupted pass has refined the middle of the image
+      deadline: time after which no more blocks are refined
+      cancel: if not nullptr, stops the render as the deadline when it
+      becomes true
+      on_pass: called after each complete pass, with the board complete and
+      as refined as the pass, to show it or to copy it for another thread
+      first_block: size of the blocks of the first pass, a power of two
+
+      the first pass is always done, so that the board is a complete image
+      even if the deadline has already passed; when every pass is done the
+      board is the one of board_gen and it has its viewport (see pan)
+
+      returns the finest complete pass
+    */
+    const Viewport frame{z_real_bound, z_im_bound, center_real,
+                         center_im,    c,          mandel_or_julia};
+    viewport = Viewport();
+    ProgressivePass progress{first_block, 0, false};
+    auto stopped = [&] {
+      return (cancel != nullptr && cancel->load()) ||
+             std::chrono::steady_clock::now() >= deadline;
+    };
+    // pixels iterated between two looks at the clock
+    const int pixels_per_check = 16;
+    for (int block = first_block; block >= 1; block /= 2) {
+      if (block != first_block && stopped()) {
+        progress.interrupted = true;
+        return progress;
+      }
+      // the corners of the blocks of this pass that are not corners of the
+      // blocks of the previous one, ring after ring around the center
+      const std::vector<std::pair<int, int>> corners =
+          ring_corners(block, block == first_block);
+      for (std::size_t k = 0; k < corners.size(); ++k) {
+        if (k > 0 && k % pixels_per_check == 0 && block != first_block &&
+            stopped()) {
+          progress.interrupted = true;
+          return progress;
+        }
+        const int x = corners[k].first;
+        const int y = corners[k].second;
+        fill_rectangle(board, dim, frame, x, x + 1, y, y + 1);
+        const double color = board[y * dim + x];
+        for (int row = y; row < std::min(y + block, dim); ++row) {
+          std::fill(board.begin() + row * dim + x,
+                    board.begin() + row * dim + std::min(x + block, dim),
+                    color);
+        }
+        progress.rendered += 1;
+      }
+      progress.block = block;
+      if (block == 1) {
+        setViewport(frame);
+      }
+      if (on_pass) {
+        on_pass(progress);
+      }
+    }
+    return progress;
+  }
+
+  const Viewport &getViewport() const { return viewport; }
+
+  int pan(const int &dx, const int &dy) {
+    /*
+      moves the frame of the board by dx pixels right and dy pixels up (the
+      pixel (x, y) becomes the one that was at (x + dx, y + dy)): the board is
+      shifted in place and only the strips of pixels that come into view are
+      rendered, so that the cost of a pan grows with the area it exposes and
+      not with the area of the board
+      the pixels kept and the ones rendered are the points a board rendered
+      from scratch on the panned frame would have (see Viewport)
+
+      returns the number of pixels rendered, 0 leaving the board as it is if
+      it was not rendered in double (see Viewport)
+    */
+    if (!viewport.valid || (dx == 0 && dy == 0)) {
+      return 0;
+    }
+    viewport.pan_x += dx;
+    viewport.pan_y += dy;
+    if (std::abs(dx) >= dim || std::abs(dy) >= dim) {
+      fill_rectangle(board, dim, viewport, 0, dim, 0, dim);
+      return dim * dim;
+    }
+    // one move of the whole board: the pixels that wrap around a row land in
+    // the strips rendered again
+    const long shift = static_cast<long>(dy) * dim + dx;
+    if (shift > 0) {
+      std::copy(board.begin() + shift, board.end(), board.begin());
+    } else {
+      std::copy_backward(board.begin(), board.end() + shift, board.end());
+    }
+    const int x_first = dx > 0 ? dim - dx : 0;
+    const int x_last = dx > 0 ? dim : -dx;
+    const int y_first = dy > 0 ? dim - dy : 0;
+    const int y_last = dy > 0 ? dim : -dy;
+    // the columns exposed on every row, then the rows exposed without them
+    fill_rectangle(board, dim, viewport, x_first, x_last, 0, dim);
+    const int kept_first = dx > 0 ? 0 : -dx;
+    const int kept_last = dx > 0 ? dim - dx : dim;
+    fill_rectangle(board, dim, viewport, kept_first, kept_last, y_first,
+                   y_last);
+    return (x_last - x_first) * dim +
+           (kept_last - kept_first) * (y_last - y_first);
+  }
+
+  static void fill_board(std::vector<double> &board, const int &dim,
+                         const double &z_real_bound, const double &z_im_bound,
+                         const DoubleDouble &center_real,
+                         const DoubleDouble &center_im,
+                         std::complex<double> c = std::complex<double>(0.0,
+                                                                       0.0),
+                         bool mandel_or_julia = true,
+                         int max_iterations = board_max_iterations) {
+    /*
+      same as fill_board in double-double: the pixel (x, y) is at
+      center + (x * z_real_bound, y * z_im_bound) computed exactly, and each
+      row is iterated double_double_lanes pixels at a time
+     */
+    fill_rectangle(board, dim, z_real_bound, z_im_bound, center_real,
+                   center_im, c, mandel_or_julia, max_iterations, 0, dim, 0,
+                   dim);
+  }
+
+  static void fill_rectangle(std::vector<double> &board, const int &dim,
+                             const double &z_real_bound,
+                             const double &z_im_bound,
+                             const DoubleDouble &center_real,
+                             const DoubleDouble &center_im,
+                             const std::complex<double> &c,
+                             const bool &mandel_or_julia,
+                             const int &max_iterations, const int &x_first,
+                             const int &x_last, const int &y_first,
+                             const int &y_last) {
+    /*
+      same as the double-double fill_board for the pixels
+      x_first <= x < x_last, y_first <= y < y_last, to render a frame in
+      tiles
+     */
+    const int lanes = double_double_lanes;
+    DoubleDouble z_real[lanes], z_im[lanes], c_real[lanes], c_im[lanes];
+    int iterations[lanes];
+    for (int y = y_first; y < y_last; ++y) {
+      const DoubleDouble im = center_im + two_prod(y, z_im_bound);
+      for (int x0 = x_first; x0 < x_last; x0 += lanes) {
+        for (int l = 0; l < lanes; ++l) {
+          // the lanes past the end of the row repeat its last pixel
+          const int x = std::min(x0 + l, x_last - 1);
+          const DoubleDouble real = center_real + two_prod(x, z_real_bound);
+          z_real[l] = mandel_or_julia ? DoubleDouble() : real;
+          z_im[l] = mandel_or_julia ? DoubleDouble() : im;
+          c_real[l] = mandel_or_julia ? real : DoubleDouble(c.real());
+          c_im[l] = mandel_or_julia ? im : DoubleDouble(c.imag());
+        }
+        num_iter_double_double_lanes<lanes>(z_real, z_im, c_real, c_im,
+                                            iterations, max_iterations);
+        for (int l = 0; l < lanes && x0 + l < x_last; ++l) {
+          board[y * dim + x0 + l] =
+              1.0 - iterations[l] / static_cast<double>(max_iterations);
+        }
+      }
+    }
+  }
+
+  static void
+  fill_board(std::vector<double> &board, const int &dim,
+             const double &z_real_bound, const double &z_im_bound,
+             const double &center_real, const double &center_im,
+             std::complex<double> c = std::complex<double>(0.0, 0.0),
+             bool mandel_or_julia = true, bool check_period = false,
+             int max_iterations = board_max_iterations) {
+    /*
+      same as board_gen but writes into a board owned by the caller, so that
+      several frames can be rendered at the same time
+      board: dim * dim vector receiving the colors
+      dim: dimension of the image
+      check_period: iterate with num_iter_periodic, same colors but faster
+      when many pixels fall in attracting cycles
+      max_iterations: iterations after which a point is considered bounded
+     */
+    fill_rectangle(board, dim,
+                   {z_real_bound, z_im_bound, center_real, center_im, c,
+                    mandel_or_julia, check_period, max_iterations},
+                   0, dim, 0, dim);
+  }
+
+  static void fill_rectangle(std::vector<double> &board, const int &dim,
+                             const Viewport &frame, const int &x_first,
+                             const int &x_last, const int &y_first,
+                             const int &y_last) {
+    /*
+      same as fill_board for the pixels x_first <= x < x_last,
+      y_first <= y < y_last of the frame of a viewport
+     */
+    for (int x = x_first; x < x_last; ++x) {
+      for (int y = y_first; y < y_last; ++y) {
+        double real =
+            (x + frame.pan_x) * frame.z_real_bound + frame.corner_real;
+        double im = (y + frame.pan_y) * frame.z_im_bound + frame.corner_im;
         int number_iterations = 0;
-        if (mandel_or_julia) {
-          number_iterations =
-              num_iter(0.0, std::complex<double>(real, im), max_iterations);
+        if (frame.mandel_or_julia) {
+          number_iterations = num_iter(0.0, std::complex<double>(real, im),
+                                       frame.max_iterations);
+        } else if (frame.check_period) {
+          number_iterations = num_iter_periodic(
+              std::complex<double>(real, im), frame.c, frame.max_iterations);
         } else {
-          number_iterations =
-              num_iter(std::complex<double>(real, im), c, max_iterations);
+          number_iterations = num_iter(std::complex<double>(real, im), frame.c,
+                                       frame.max_iterations);
+        }
+        board[y * dim + x] =
+            1.0 - number_iterations / static_cast<double>(frame.max_iterations);
+      }
+    }
+  }
+
+  static void fill_float_board(std::vector<double> &board, const int &dim,
+                               const double &z_real_bound,
+                               const double &z_im_bound,
+                               const double &center_real,
+                               const double &center_im,
+                               const int &max_iterations) {
+    /*
+      same as fill_board for the mandelbrot set in float, float_lanes pixels
+      of a row at a time: twice the lanes of double in a SIMD register, for
+      shallow frames whose pixels are far apart
+     */
+    const int lanes = float_lanes;
+    float c_real[lanes], c_im[lanes], z_real[lanes], z_im[lanes];
+    int iterations[lanes];
+    for (int y = 0; y < dim; ++y) {
+      for (int x0 = 0; x0 < dim; x0 += lanes) {
+        for (int l = 0; l < lanes; ++l) {
+          // the lanes past the end of the row repeat its last pixel
+          const int x = std::min(x0 + l, dim - 1);
+          c_real[l] = static_cast<float>(x * z_real_bound + center_real);
+          c_im[l] = static_cast<float>(y * z_im_bound + center_im);
+          z_real[l] = 0.0f;
+          z_im[l] = 0.0f;
+          iterations[l] = 0;
+        }
+        for (int n = 0; n < max_iterations; ++n) {
+          int running = 0;
+          for (int l = 0; l < lanes; ++l) {
+            const float zr2 = z_real[l] * z_real[l];
+            const float zi2 = z_im[l] * z_im[l];
+            const bool inside = zr2 + zi2 < 4.0f;
+            const float next_im = 2.0f * z_real[l] * z_im[l] + c_im[l];
+            z_real[l] = inside ? zr2 - zi2 + c_real[l] : z_real[l];
+            z_im[l] = inside ? next_im : z_im[l];
+            iterations[l] += inside;
+            running += inside;
+          }
+          if (running == 0) {
+            break;
+          }
+        }
+        for (int l = 0; l < lanes && x0 + l < dim; ++l) {
+          board[y * dim + x0 + l] =
+              1.0 - iterations[l] / static_cast<double>(max_iterations);
         }
-        this->board[y * this->dim + x] =
-            1.0 - number_iterations / static_cast<double>(max_iterations);
       }
     }
   }
@@ -92,19 +916,37 @@ public:
       filename: name of the file containing data
       dirname: name of the directory containing the image
      */
+    write_board(this->board, this->dim, filename, dirname);
+  }
+
+  static void write_board(const std::vector<double> &board, const int &dim,
+                          const std::string &filename,
+                          const std::string &dirname) {
+    /*
+      same as save_to_file for a board owned by the caller
+     */
+    write_image(board, dim, dim, filename, dirname);
+  }
+
+  static void write_image(const std::vector<double> &image, const int &width,
+                          const int &height, const std::string &filename,
+                          const std::string &dirname) {
+    /*
+      saves a width x height image, stored row by row, in a given directory
+      with a given filename
+     */
     std::string path = "./";
     std::string fn = path + dirname + "/" + filename + ".ppm";
     std::ofstream outfile(fn);
 
     // ppm format, the following lines are standard
     outfile << "P3\n";
-    outfile << dim << " " << dim << "\n";
+    outfile << width << " " << height << "\n";
     outfile << "255\n";
 
-    for (int i = 0; i < this->dim; i++) {
-      for (int j = 0; j < this->dim; j++) {
-        int pixel_value =
-            static_cast<int>(this->board[i * this->dim + j] * 255);
+    for (int i = 0; i < height; i++) {
+      for (int j = 0; j < width; j++) {
+        int pixel_value = static_cast<int>(image[i * width + j] * 255);
         outfile << pixel_value << " " << pixel_value << " " << pixel_value
                 << " ";
       }
@@ -113,96 +955,1426 @@ public:
 
     outfile.close();
   }
-};
 
-class Mandelbrot : public Fractals {
-  // class that inherits from Fractals
-  // creates and renders the mandelbrot set
-private:
-  std::string data_dir;
-public:
-  Mandelbrot(int dim) : Fractals(dim), data_dir("MANDELBROT") {
-    smkdir(this->data_dir);
+protected:
+  void setBoard(std::vector<double> new_board) {
+    // the generators set the viewport of the boards they render in double
+    board = std::move(new_board);
+    viewport = Viewport();
   }
-  std::complex<double> boundries(const double &scaling_factor) {
-    /*
-      calculates the boundries of an image of the mandelbrot set for a given
-      scaling factor
-      scaling_factor: the scaling factor of the image
 
-      returns a complex number, the boundries of the images are the real and
-      imaginary parts of this number
+  std::vector<std::pair<int, int>> ring_corners(const int &block,
+                                                const bool &all) const {
+    /*
+      corners of the block x block blocks of the board, ring after ring
+      around its center and around each ring counterclockwise, as the angle
+      of atan2 grows: a corner is in the ring of the larger of the rings of
+      its column and of its row, so the rings are the borders of nested
+      rectangles and are walked side by side, without sorting
+      all: every corner, otherwise only the ones that are not corners of the
+      blocks twice as large
     */
+    const int side = (dim + block - 1) / block;
+    const double middle = 0.5 * (dim - 1);
+    // the column (row) of ring r before and after the middle, -1 if the
+    // ring is past the border of the board on that side
+    std::vector<int> before(side + 1, -1);
+    std::vector<int> after(side + 1, -1);
+    // the first and last columns (rows) of the rectangle of ring r
+    std::vector<int> first_of(side + 1, side);
+    std::vector<int> last_of(side + 1, -1);
+    int rings = 0;
+    for (int i = 0; i < side; ++i) {
+      const double offset = i * block - middle;
+      const int ring = static_cast<int>(std::abs(offset) / block);
+      (offset < 0.0 ? before : after)[ring] = i;
+      first_of[ring] = std::min(first_of[ring], i);
+      last_of[ring] = std::max(last_of[ring], i);
+      rings = std::max(rings, ring + 1);
+    }
+    for (int r = 1; r < rings; ++r) {
+      first_of[r] = std::min(first_of[r], first_of[r - 1]);
+      last_of[r] = std::max(last_of[r], last_of[r - 1]);
+    }
+    std::vector<std::pair<int, int>> corners;
+    corners.reserve(all ? side * side : side * side - (side + 1) / 2 *
+                                                          ((side + 1) / 2));
+    auto add = [&](const int &i, const int &j) {
+      if (all || i % 2 != 0 || j % 2 != 0) {
+        corners.push_back({i * block, j * block});
+      }
+    };
+    // first row below the middle, where the walk starts
+    int middle_row = 0;
+    while (middle_row < side && middle_row * block < middle) {
+      middle_row += 1;
+    }
+    for (int r = 0; r < rings; ++r) {
+      // the board is square, the rows of a ring are the same as its columns
+      const int left = before[r];
+      const int right = after[r];
+      const int top = left;
+      const int bottom = right;
+      const int first = first_of[r];
+      const int last = last_of[r];
+      // the columns own the corners of the rectangle
+      const int inner_first = left >= 0 ? left + 1 : first;
+      const int inner_last = right >= 0 ? right - 1 : last;
+      if (right >= 0) {
+        for (int j = std::max(middle_row, first); j <= last; ++j) {
+          add(right, j);
+        }
+      }
+      if (bottom >= 0) {
+        for (int i = inner_last; i >= inner_first; --i) {
+          add(i, bottom);
+        }
+      }
+      if (left >= 0) {
+        for (int j = last; j >= first; --j) {
+          add(left, j);
+        }
+      }
+      if (top >= 0) {
+        for (int i = inner_first; i <= inner_last; ++i) {
+          add(i, top);
+        }
+      }
+      if (right >= 0) {
+        for (int j = first; j < std::min(middle_row, last + 1); ++j) {
+          add(right, j);
+        }
+      }
+    }
+    return corners;
+  }
 
-    const double unscaled_real_domain = 2.48;
-    const double unscaled_im_domain = 2.26;
-
-    const double z_real_bound =
-        unscaled_real_domain * scaling_factor / (getDimension() - 1);
-    const double z_im_bound =
-        unscaled_im_domain * scaling_factor / (getDimension() - 1);
-    return std::complex(z_real_bound, z_im_bound);
+  void setViewport(Viewport frame) {
+    frame.valid = true;
+    viewport = frame;
   }
+};
 
-  void mandelbrot_generator(const double &scaling_factor,
-                            const double &center_real,
-                            const double &center_im) {
-    /*
-      Creates the mandelbrot set and saves it to file
-      scaling_factor: it's the level of zoom on the image
-      center_real: where the image is centered on the real axis
-      center_im: where the image is centered on the imaginary axis
-     */
-    bool mandelbrot_mode = true; // sets the mode to mandelbrot
+class LazyFrame {
+  /*
+    board of a viewport (see Viewport) whose tiles are rendered the first time
+    one of their pixels is read: crops and regions of interest cost the tiles
+    they touch, not the whole board. The pixels are the ones of fill_board,
+    and any number of threads may read them at the same time, each tile being
+    rendered once; a frame can be moved, not while it is being read
+  */
+private:
+  Viewport frame;
+  int dim;
+  int tile;
+  int tiles_per_side;
+  std::vector<double> board;
+  std::unique_ptr<std::once_flag[]> rendered;
+  // behind pointers like the flags, so that the frame can be moved
+  std::unique_ptr<std::atomic<int>> rendered_tiles;
 
-    const double real_bound = boundries(scaling_factor).real();
-    const double im_bound = boundries(scaling_factor).imag();
+  void render_tile(const int &tile_x, const int &tile_y) {
+    std::call_once(rendered[tile_y * tiles_per_side + tile_x], [&] {
+      Fractals::fill_rectangle(board, dim, frame, tile_x * tile,
+                               std::min(dim, (tile_x + 1) * tile),
+                               tile_y * tile,
+                               std::min(dim, (tile_y + 1) * tile));
+      *rendered_tiles += 1;
+    });
+  }
 
-    // if zooming on the image the center of the image needs to change
-    const double zoom_center_real = center_real - 2.0 * scaling_factor;
-    const double zoom_center_im = center_im - 1.13 * scaling_factor;
+public:
+  LazyFrame(const Viewport &frame, const int &dim,
+            const int &tile = lazy_tile)
+      : frame(frame), dim(dim), tile(tile),
+        tiles_per_side((dim + tile - 1) / tile), board(dim * dim, 1.0),
+        rendered(new std::once_flag[tiles_per_side * tiles_per_side]),
+        rendered_tiles(std::make_unique<std::atomic<int>>(0)) {}
 
-    board_gen(real_bound, im_bound, zoom_center_real, zoom_center_im,
-              mandelbrot_mode);
+  int getDimension() const { return dim; }
+  int getRenderedTiles() const { return *rendered_tiles; }
+  int getTiles() const { return tiles_per_side * tiles_per_side; }
 
-    // the file in which the image is stored is called as its scaling_factor
-    std::string filename = std::to_string(scaling_factor);
-    save_to_file(filename, this->data_dir);
+  double at(const int &x, const int &y) {
+    // color of the pixel (x, y), rendering its tile if needed
+    if (x < 0 || x >= dim || y < 0 || y >= dim) {
+      throw std::out_of_range("pixel outside the frame");
+    }
+    render_tile(x / tile, y / tile);
+    return board[y * dim + x];
   }
 
-  void mandelbrot_multiple_images(const int &end_scaling_factor,
-                                  const double &step,
-                                  const double &zoom_center_real,
-                                  const double &zoom_center_im) {
+  std::vector<double> region(const int &x, const int &y, const int &width,
+                             const int &height, const bool &parallel = false) {
     /*
-      generates multiple images of the mandebrot set by calling the generate
-      mandelbrot function end_scaling_factor: last scaling factor before
-      stopping zoom zoom_center_real: where the image is centered on the real
-      axis zoom_center_im: where the image is centered on the imaginary axis
+      crop of the board, width x height pixels from (x, y) stored row by row,
+      rendering only the tiles it touches
+      parallel: render those tiles on the shared pool, not from a job of the
+      pool
+      throws std::out_of_range if the crop does not fit in the board, an
+      empty crop renders nothing
     */
-    double scaling_factor = 3.0;
-    while (scaling_factor > end_scaling_factor) {
-      scaling_factor = scaling_factor - step;
-      mandelbrot_generator(scaling_factor, zoom_center_real, zoom_center_im);
+    if (x < 0 || y < 0 || width < 0 || height < 0 || x > dim - width ||
+        y > dim - height) {
+      throw std::out_of_range("region outside the frame");
+    }
+    if (width == 0 || height == 0) {
+      return {};
+    }
+    const int first_x = x / tile;
+    const int first_y = y / tile;
+    const int columns = (x + width - 1) / tile - first_x + 1;
+    const int rows = (y + height - 1) / tile - first_y + 1;
+    auto render = [&](const int &job) {
+      render_tile(first_x + job % columns, first_y + job / columns);
+    };
+    if (parallel) {
+      parallel_jobs(columns * rows, render);
+    } else {
+      for (int job = 0; job < columns * rows; ++job) {
+        render(job);
+      }
+    }
+    std::vector<double> crop(static_cast<std::size_t>(width) * height);
+    for (int row = 0; row < height; ++row) {
+      std::copy(board.begin() + (y + row) * dim + x,
+                board.begin() + (y + row) * dim + x + width,
+                crop.begin() + row * width);
     }
+    return crop;
+  }
+
+  const std::vector<double> &getBoard(const bool &parallel = false) {
+    // the whole board, rendering the tiles not read yet
+    region(0, 0, dim, dim, parallel);
+    return board;
   }
 };
 
-class Julia : public Fractals {
-  // class that inherits from Fractals
-  // creates and renders the  julia sets
-private:
-  std::string data_dir;
-public:
-  Julia(int dim) : Fractals(dim), data_dir("JULIA") { smkdir(this->data_dir); }
+std::string scale_name(const double &scaling_factor) {
+  /*
+    name of the file of a frame with a given scaling factor in scientific
+    notation, std::to_string would call every frame deeper than 1e-6 "0.000000"
+  */
+  std::ostringstream name;
+  name << std::scientific << std::setprecision(6) << scaling_factor;
+  return name.str();
+}
 
-  void julia_generator(const std::complex<double> &c) {
-    /*
-      generates a single julia set for a given c complex constant
-      c: complex constant associated to the julia set generated
+std::string scale_name(const FloatExp &scaling_factor) {
+  /*
+    same as scale_name for scaling factors out of the range of double
+  */
+  if (scaling_factor.getExponent() > rescaled_exponent) {
+    return scale_name(static_cast<double>(scaling_factor));
+  }
+  return scientific(scaling_factor);
+}
+
+std::string sequence_name(const int &frame, const FloatExp &scaling_factor) {
+  /*
+    name of the file of a frame of a deep zoom, numbered so that sorting the
+    names sorts the frames
+  */
+  std::ostringstream name;
+  name << std::setw(5) << std::setfill('0') << frame << "_"
+       << scale_name(scaling_factor);
+  return name.str();
+}
+
+enum class Engine {
+  // numeric engines of the precision ladder, from the cheapest to the most
+  // precise: a zoom sequence renders each frame with the first one that
+  // resolves it (see Mandelbrot::mandelbrot_engine)
+  Float,
+  Double,
+  DoubleDouble,
+  Perturbation,
+  PerturbationFloatExp
+};
+
+std::string engine_name(const Engine &engine) {
+  switch (engine) {
+  case Engine::Float:
+    return "float";
+  case Engine::Double:
+    return "double";
+  case Engine::DoubleDouble:
+    return "double-double";
+  case Engine::Perturbation:
+    return "perturbation";
+  case Engine::PerturbationFloatExp:
+    return "perturbation-floatexp";
+  }
+  return "unknown";
+}
+
+Engine ladder_engine(const FloatExp &scaling_factor,
+                     const double &pixel_spacing, const int &max_iterations,
+                     const Engine &cheapest) {
+  /*
+    cheapest engine, not below cheapest, that renders a frame with pixels
+    pixel_spacing apart and max_iterations: float and double as long as its
+    pixels are float_spacing and double_spacing apart, double-double down
+    to double_double_spacing, perturbation below, rescaled when the scaling
+    factor leaves the range of double; float and double-double are skipped
+    for frames iterated more than their maximum iterations
+    a scaling factor of 0 or below (the last frame of a zoom reaching 0)
+    puts every pixel on the same point, which needs no more than double;
+    positive ones whose spacing underflows double are rescaled
+  */
+  if (!(scaling_factor.getMantissa() > 0.0)) {
+    return std::max(cheapest, Engine::Double);
+  }
+  if (scaling_factor.getExponent() <= rescaled_exponent) {
+    return Engine::PerturbationFloatExp;
+  }
+  if (cheapest <= Engine::Float && pixel_spacing >= float_spacing &&
+      max_iterations <= float_max_iterations) {
+    return Engine::Float;
+  }
+  if (cheapest <= Engine::Double && pixel_spacing >= double_spacing) {
+    return Engine::Double;
+  }
+  if (cheapest <= Engine::DoubleDouble &&
+      pixel_spacing >= double_double_spacing &&
+      max_iterations <= double_double_max_iterations) {
+    return Engine::DoubleDouble;
+  }
+  return cheapest <= Engine::Perturbation ? Engine::Perturbation : cheapest;
+}
+
+struct FrameRecord {
+  // how a frame of a zoom sequence has been rendered
+  int frame;
+  FloatExp scaling_factor;
+  Engine engine;
+};
+
+std::string frame_log(const FrameRecord &record) {
+  // one line of the log of a zoom sequence
+  std::ostringstream line;
+  line << "frame " << std::setw(5) << std::setfill('0') << record.frame << " "
+       << scale_name(record.scaling_factor) << ": "
+       << engine_name(record.engine);
+  return line.str();
+}
+
+std::vector<double> linear_scaling_factors(const double &end_scaling_factor,
+                                           const double &step) {
+  /*
+    scaling factors of a linear zoom from 3 down to end_scaling_factor, the
+    frames of mandelbrot_multiple_images: computed as 3 - k step rather than
+    by subtracting step again and again, whose rounding leaves a residue of
+    about 1e-14 where the zoom should reach 0; factors closer to 0 than half
+    a step are 0
+  */
+  std::vector<double> scaling_factors;
+  double scaling_factor = 3.0;
+  for (int k = 1; scaling_factor > end_scaling_factor; ++k) {
+    scaling_factor = 3.0 - k * step;
+    if (std::abs(scaling_factor) < 0.5 * step) {
+      scaling_factor = 0.0;
+    }
+    scaling_factors.push_back(scaling_factor);
+  }
+  return scaling_factors;
+}
+
+struct ExponentialMap {
+  /*
+    log-polar strip of a zoom: column a, row r is the point at
+      outer_radius exp(-2 pi r / width) exp(2 pi i a / width)
+    from the zoom center, so that every row is one turn around the center
+    and each row is closer by the same ratio: pixels are square at any
+    depth, and a frame of any scaling factor is a resampling of some rows
+  */
+  int width = 0; // columns, one turn around the center
+  int rows = 0;
+  double outer_radius = 0.0;
+  std::vector<double> strip; // colors, row by row
+};
+
+double exponential_sample(const ExponentialMap &map,
+                          const std::complex<double> &offset) {
+  /*
+    color of the point at offset from the zoom center, interpolated between
+    the four samples of the strip around it; points out of the strip take
+    the color of its first or last row
+  */
+  const double two_pi = 2.0 * std::acos(-1.0);
+  const double radius = std::max(std::abs(offset), 1e-300);
+  double angle = std::arg(offset);
+  angle = angle < 0.0 ? angle + two_pi : angle;
+  const double column = angle * map.width / two_pi;
+  const double row = std::clamp(map.width / two_pi *
+                                    std::log(map.outer_radius / radius),
+                                0.0, map.rows - 1.0);
+  const int a0 = static_cast<int>(column) % map.width;
+  const int a1 = (a0 + 1) % map.width;
+  const int r0 = std::min(static_cast<int>(row), map.rows - 1);
+  const int r1 = std::min(r0 + 1, map.rows - 1);
+  const double u = column - std::floor(column);
+  const double v = row - r0;
+  const double *first = &map.strip[r0 * map.width];
+  const double *second = &map.strip[r1 * map.width];
+  return (1.0 - v) * ((1.0 - u) * first[a0] + u * first[a1]) +
+         v * ((1.0 - u) * second[a0] + u * second[a1]);
+}
+
+struct Keyframe {
+  /*
+    oversized frame of a keyframe zoom: the samples are the points
+      center + (i spacing, j spacing)
+    for i from -left to right and j from -half_height to half_height, a grid
+    aligned on the zoom center so that halving the spacing keeps every other
+    sample on a sample of the previous keyframe
+  */
+  double spacing = 0.0;
+  int left = 0;
+  int right = 0;
+  int half_height = 0;
+  std::vector<int> iterations; // row by row, from j = -half_height
+  int iterated = 0; // samples iterated for this keyframe
+  int reused = 0;   // samples copied from the previous keyframe
+
+  int columns() const { return left + right + 1; }
+  int rows() const { return 2 * half_height + 1; }
+};
+
+struct CameraKey {
+  // where the camera of a zoom is at a given time
+  double time;
+  FloatExp scaling_factor;
+  double center_real;
+  double center_im;
+  double rotation = 0.0; // radians, counterclockwise around the center
+};
+
+CameraKey camera_at(const std::vector<CameraKey> &path, const double &time) {
+  /*
+    camera of a path of keys in increasing time at any time, clamped to its
+    first and last keys: between two keys the scaling factor changes by the
+    same ratio in equal times, so the zoom speed is the same at every depth,
+    and the center moves by (1 - r**u) / (1 - r) of the way at the fraction
+    u of the interval zooming by r, as fast as the frame shrinks: a point
+    in view moves across the screen at the same pace at any depth. The
+    rotation is interpolated linearly
+  */
+  if (time <= path.front().time) {
+    return path.front();
+  }
+  if (time >= path.back().time) {
+    return path.back();
+  }
+  const auto next = std::upper_bound(
+      path.begin(), path.end(), time,
+      [](const double &t, const CameraKey &key) { return t < key.time; });
+  const CameraKey &a = *(next - 1);
+  const CameraKey &b = *next;
+  const double u = (time - a.time) / (b.time - a.time);
+
+  // ratio r = exp(log_ratio), the powers of r may leave the range of double
+  const double log_ratio =
+      (b.scaling_factor / a.scaling_factor).log10() * std::log(10.0);
+  const double log2_power = u * log_ratio / std::log(2.0);
+  const double whole = std::floor(log2_power);
+  double weight = u;
+  if (log_ratio < -1e-9) {
+    weight = std::expm1(u * log_ratio) / std::expm1(log_ratio);
+  } else if (log_ratio > 1e-9) {
+    weight = std::exp((u - 1.0) * log_ratio) * std::expm1(-u * log_ratio) /
+             std::expm1(-log_ratio);
+  }
+
+  CameraKey camera;
+  camera.time = time;
+  camera.scaling_factor =
+      a.scaling_factor *
+      FloatExp(std::exp2(log2_power - whole), static_cast<int>(whole));
+  camera.center_real = a.center_real + weight * (b.center_real - a.center_real);
+  camera.center_im = a.center_im + weight * (b.center_im - a.center_im);
+  camera.rotation = a.rotation + u * (b.rotation - a.rotation);
+  return camera;
+}
+
+double engine_cost(const Engine &engine) {
+  /*
+    rough time of an iteration of a pixel with each engine, relative to
+    double, for the planner of the camera paths
+  */
+  switch (engine) {
+  case Engine::Float:
+    return 0.5;
+  case Engine::Double:
+    return 1.0;
+  case Engine::DoubleDouble:
+    return 10.0;
+  case Engine::Perturbation:
+    return 2.0;
+  case Engine::PerturbationFloatExp:
+    return 4.0;
+  }
+  return 1.0;
+}
+
+struct CameraFrame {
+  // a frame of a camera path as planned before rendering
+  int frame;
+  CameraKey camera;
+  Engine engine;
+  double cost; // estimated time, in iterations of a pixel in double
+};
+
+class Mandelbrot : public Fractals {
+  // class that inherits from Fractals
+  // creates and renders the mandelbrot set
+private:
+  std::string data_dir;
+public:
+  Mandelbrot(int dim) : Fractals(dim), data_dir("MANDELBROT") {
+    smkdir(this->data_dir);
+  }
+  std::complex<double> boundries(const double &scaling_factor) const {
+    /*
+      calculates the boundries of an image of the mandelbrot set for a given
+      scaling factor
+      scaling_factor: the scaling factor of the image
+
+      returns a complex number, the boundries of the images are the real and
+      imaginary parts of this number
     */
-    bool julia_mode = false; // sets the mode to Julia
 
+    const double unscaled_real_domain = 2.48;
+    const double unscaled_im_domain = 2.26;
+
+    const double z_real_bound =
+        unscaled_real_domain * scaling_factor / (getDimension() - 1);
+    const double z_im_bound =
+        unscaled_im_domain * scaling_factor / (getDimension() - 1);
+    return std::complex(z_real_bound, z_im_bound);
+  }
+
+  std::vector<double> mandelbrot_board(const double &scaling_factor,
+                                       const double &center_real,
+                                       const double &center_im) {
+    /*
+      renders the mandelbrot set into a new board without touching the one of
+      the object, used by the generators and by the parallel sweeps
+      scaling_factor: it's the level of zoom on the image
+      center_real: where the image is centered on the real axis
+      center_im: where the image is centered on the imaginary axis
+
+      when the pixels are closer than double_spacing the frame is rendered
+      in double-double, which keeps it sharp down to about 1e-28
+     */
+    const double real_bound = boundries(scaling_factor).real();
+    const double im_bound = boundries(scaling_factor).imag();
+
+    std::vector<double> board(getDimension() * getDimension(), 1.0);
+    if (real_bound < double_spacing) {
+      fill_board(board, getDimension(), real_bound, im_bound,
+                 two_sum(center_real, -2.0 * scaling_factor),
+                 two_sum(center_im, -1.13 * scaling_factor));
+      return board;
+    }
+
+    // if zooming on the image the center of the image needs to change
+    const double zoom_center_real = center_real - 2.0 * scaling_factor;
+    const double zoom_center_im = center_im - 1.13 * scaling_factor;
+
+    fill_board(board, getDimension(), real_bound, im_bound, zoom_center_real,
+               zoom_center_im);
+    return board;
+  }
+
+  LazyFrame mandelbrot_lazy_frame(const double &scaling_factor,
+                                  const double &center_real,
+                                  const double &center_im,
+                                  const int &tile = lazy_tile) {
+    /*
+      frame of mandelbrot_board whose tiles are rendered when read (see
+      LazyFrame), for frames rendered in double: throws std::invalid_argument
+      for pixels closer than double_spacing, that mandelbrot_board renders in
+      double-double
+     */
+    const std::complex<double> bounds = boundries(scaling_factor);
+    if (bounds.real() < double_spacing) {
+      throw std::invalid_argument(
+          "lazy frames are rendered in double, scaling_factor is too small");
+    }
+    return LazyFrame({bounds.real(), bounds.imag(),
+                      center_real - 2.0 * scaling_factor,
+                      center_im - 1.13 * scaling_factor},
+                     getDimension(), tile);
+  }
+
+  Engine mandelbrot_engine(const FloatExp &scaling_factor,
+                           const int &max_iterations,
+                           const Engine &cheapest = Engine::Float) {
+    /*
+      engine of the precision ladder for a frame of the given scaling factor
+      (see ladder_engine)
+     */
+    return ladder_engine(
+        scaling_factor, boundries(static_cast<double>(scaling_factor)).real(),
+        max_iterations, cheapest);
+  }
+
+  std::vector<double> mandelbrot_engine_board(const Engine &engine,
+                                              const FloatExp &scaling_factor,
+                                              const double &center_real,
+                                              const double &center_im,
+                                              const int &max_iterations,
+                                              ReferenceCache *cache = nullptr) {
+    /*
+      renders the frame of mandelbrot_board with a given engine, for the zoom
+      sequences: the double and double-double ones are the same as
+      mandelbrot_board with max_iterations
+      cache: orbit of the center for the perturbation engines
+     */
+    if (engine == Engine::Perturbation ||
+        engine == Engine::PerturbationFloatExp) {
+      return mandelbrot_deep_board(scaling_factor, center_real, center_im,
+                                   max_iterations, false, cache);
+    }
+    const double factor = static_cast<double>(scaling_factor);
+    const double real_bound = boundries(factor).real();
+    const double im_bound = boundries(factor).imag();
+    std::vector<double> board(getDimension() * getDimension(), 1.0);
+    if (engine == Engine::Float) {
+      fill_float_board(board, getDimension(), real_bound, im_bound,
+                       center_real - 2.0 * factor, center_im - 1.13 * factor,
+                       max_iterations);
+    } else if (engine == Engine::Double) {
+      fill_board(board, getDimension(), real_bound, im_bound,
+                 center_real - 2.0 * factor, center_im - 1.13 * factor,
+                 std::complex<double>(0.0, 0.0), true, false, max_iterations);
+    } else {
+      fill_board(board, getDimension(), real_bound, im_bound,
+                 two_sum(center_real, -2.0 * factor),
+                 two_sum(center_im, -1.13 * factor),
+                 std::complex<double>(0.0, 0.0), true, max_iterations);
+    }
+    return board;
+  }
+
+  void share_reference(ReferenceCache &cache,
+                       const std::vector<FrameRecord> &records,
+                       const int &max_iterations) {
+    /*
+      computes the reference orbit of a zoom once, at the precision of its
+      deepest perturbation frame (the last one, the engines never going back
+      down the ladder), before the frames share it: the orbit of the nucleus
+      of lowest period of that frame, that all the frames contain, or of the
+      center if it has none. A cache read from disk that is already good
+      enough is kept as it is
+     */
+    if (records.empty() || records.back().engine < Engine::Perturbation) {
+      return;
+    }
+    const FloatExp &deepest = records.back().scaling_factor;
+    const int scale_exponent =
+        records.back().engine == Engine::PerturbationFloatExp
+            ? deepest.getExponent()
+            : 0;
+    const double factor = deepest.scaled(scale_exponent);
+    const std::complex<double> bounds = boundries(factor);
+    const double pixel_spacing = std::min(bounds.real(), bounds.imag());
+    if (cache.getIterations() < max_iterations ||
+        cache.getBits() < reference_bits(pixel_spacing, scale_exponent)) {
+      ReferenceOrbit center;
+      center.scale_exponent = scale_exponent;
+      const std::complex<double> low(-2.0 * factor, -1.13 * factor);
+      const Nucleus nucleus = find_nucleus(
+          center,
+          start_reference_orbit(center, cache.getCenter().real(),
+                                cache.getCenter().imag(), 0.0,
+                                reference_bits(pixel_spacing, scale_exponent),
+                                scale_exponent),
+          low, low + std::complex<double>(2.48 * factor, 2.26 * factor),
+          max_iterations);
+      if (nucleus.period > 0) {
+        cache.set_reference(nucleus.offset, scale_exponent);
+      }
+    }
+    cache.orbit(max_iterations, pixel_spacing, scale_exponent);
+  }
+
+  void mandelbrot_generator(const double &scaling_factor,
+                            const double &center_real,
+                            const double &center_im) {
+    /*
+      Creates the mandelbrot set and saves it to file
+      scaling_factor: it's the level of zoom on the image
+      center_real: where the image is centered on the real axis
+      center_im: where the image is centered on the imaginary axis
+     */
+    setBoard(mandelbrot_board(scaling_factor, center_real, center_im));
+    const std::complex<double> bounds = boundries(scaling_factor);
+    if (bounds.real() >= double_spacing) {
+      setViewport({bounds.real(), bounds.imag(),
+                   center_real - 2.0 * scaling_factor,
+                   center_im - 1.13 * scaling_factor});
+    }
+
+    // the file in which the image is stored is called as its scaling_factor
+    std::string filename = std::to_string(scaling_factor);
+    save_to_file(filename, this->data_dir);
+  }
+
+  std::vector<FrameRecord> mandelbrot_multiple_images(
+      const double &end_scaling_factor, const double &step,
+      const double &zoom_center_real, const double &zoom_center_im,
+      const std::size_t &memory_budget = default_memory_budget) {
+    /*
+      generates multiple images of the mandebrot set by calling the generate
+      mandelbrot function end_scaling_factor: last scaling factor before
+      stopping zoom zoom_center_real: where the image is centered on the real
+      axis zoom_center_im: where the image is centered on the imaginary axis
+      memory_budget: bytes that frames rendered in parallel may occupy before
+      being written, the frames are still written in zoom order
+
+      each frame is rendered by the cheapest engine from double up (see
+      mandelbrot_engine), logged to std::cout as it is written; returns the
+      engine of every frame
+    */
+    const std::vector<double> scaling_factors =
+        linear_scaling_factors(end_scaling_factor, step);
+
+    std::vector<FrameRecord> records;
+    for (std::size_t frame = 0; frame < scaling_factors.size(); ++frame) {
+      records.push_back(
+          {static_cast<int>(frame), scaling_factors[frame],
+           mandelbrot_engine(scaling_factors[frame], board_max_iterations,
+                             Engine::Double)});
+    }
+    ReferenceCache cache(zoom_center_real, zoom_center_im);
+    share_reference(cache, records, board_max_iterations);
+
+    const int dim = getDimension();
+    const int max_in_flight =
+        jobs_in_flight(memory_budget, dim * dim * sizeof(double));
+    ordered_parallel_jobs(
+        scaling_factors.size(), max_in_flight,
+        [&](const int &frame) {
+          return mandelbrot_engine_board(records[frame].engine,
+                                         scaling_factors[frame],
+                                         zoom_center_real, zoom_center_im,
+                                         board_max_iterations, &cache);
+        },
+        [&](const int &frame, std::vector<double> board) {
+          std::cout << frame_log(records[frame]) << "\n";
+          write_board(board, dim, std::to_string(scaling_factors[frame]),
+                      this->data_dir);
+          // the object keeps the last frame, as the serial loop used to
+          if (frame + 1 == static_cast<int>(scaling_factors.size())) {
+            setBoard(std::move(board));
+          }
+        });
+    return records;
+  }
+
+  ExponentialMap mandelbrot_exponential_map(const double &outer_radius,
+                                            const double &inner_radius,
+                                            const double &center_real,
+                                            const double &center_im,
+                                            const int &max_iterations =
+                                                board_max_iterations) {
+    /*
+      renders the log-polar strip (see ExponentialMap) of the mandelbrot set
+      around (center_real, center_im), from outer_radius down to
+      inner_radius, its rows split among the shared pool
+      the strip has as many columns as the pixels around the corner of a
+      frame, so that its samples are never farther apart than the pixels of
+      the frames resampled from it (see exponential_frame)
+
+      the points of the strip are in double, zooms deeper than double_spacing
+      need the perturbation engines of mandelbrot_deep_multiple_images
+     */
+    const double two_pi = 2.0 * std::acos(-1.0);
+    ExponentialMap map;
+    map.width = static_cast<int>(std::ceil(
+        two_pi * std::hypot(2.0, 1.13) * (getDimension() - 1) / 2.48));
+    map.outer_radius = outer_radius;
+    map.rows = static_cast<int>(std::ceil(map.width / two_pi *
+                                          std::log(outer_radius /
+                                                   inner_radius))) +
+               2;
+    map.strip.resize(static_cast<std::size_t>(map.width) * map.rows);
+    parallel_jobs(map.rows, [&](const int &row) {
+      const double radius =
+          outer_radius * std::exp(-two_pi * row / map.width);
+      for (int column = 0; column < map.width; ++column) {
+        const std::complex<double> c =
+            std::complex<double>(center_real, center_im) +
+            std::polar(radius, two_pi * column / map.width);
+        map.strip[row * map.width + column] =
+            1.0 - num_iter(0.0, c, max_iterations) /
+                      static_cast<double>(max_iterations);
+      }
+    });
+    return map;
+  }
+
+  std::vector<double> exponential_frame(const ExponentialMap &map,
+                                        const double &scaling_factor) {
+    /*
+      frame of mandelbrot_board(scaling_factor, ...) around the center of
+      map, resampled from the strip instead of rendered: about dim**2
+      interpolations, no iteration
+     */
+    const int dim = getDimension();
+    const std::complex<double> bounds = boundries(scaling_factor);
+    std::vector<double> board(dim * dim, 1.0);
+    for (int y = 0; y < dim; ++y) {
+      for (int x = 0; x < dim; ++x) {
+        const std::complex<double> offset(
+            x * bounds.real() - 2.0 * scaling_factor,
+            y * bounds.imag() - 1.13 * scaling_factor);
+        board[y * dim + x] = exponential_sample(map, offset);
+      }
+    }
+    return board;
+  }
+
+  ExponentialMap mandelbrot_exponential_images(
+      const double &end_scaling_factor, const double &step,
+      const double &zoom_center_real, const double &zoom_center_im) {
+    /*
+      same frames and files as mandelbrot_multiple_images, resampled from one
+      exponential map of the zoom (see mandelbrot_exponential_map) instead of
+      rendered one by one: the iterations are the ones of the strip, whose
+      rows grow with the logarithm of the zoom depth, not with the number of
+      frames; the colors differ from the rendered frames by the
+      interpolation, on the boundary pixels
+
+      returns the exponential map
+    */
+    const std::vector<double> scaling_factors =
+        linear_scaling_factors(end_scaling_factor, step);
+    if (scaling_factors.empty()) {
+      return ExponentialMap();
+    }
+
+    // from the farthest corner of the first frame to half a pixel of the
+    // deepest one, frames of scaling factor 0 take the innermost row; the
+    // strip, in double, resolves nothing closer than double_spacing
+    double deepest = scaling_factors.front();
+    for (const double &factor : scaling_factors) {
+      deepest = factor > 0.0 ? std::min(deepest, factor) : deepest;
+    }
+    const double outer_radius =
+        std::hypot(2.0, 1.13) * std::abs(scaling_factors.front());
+    const double inner_radius =
+        std::max(0.5 * boundries(deepest).imag(), double_spacing);
+    const ExponentialMap map = mandelbrot_exponential_map(
+        std::max(outer_radius, inner_radius), inner_radius, zoom_center_real,
+        zoom_center_im);
+
+    parallel_jobs(scaling_factors.size(), [&](const int &frame) {
+      write_board(exponential_frame(map, scaling_factors[frame]),
+                  getDimension(), std::to_string(scaling_factors[frame]),
+                  this->data_dir);
+    });
+    setBoard(exponential_frame(map, scaling_factors.back()));
+    return map;
+  }
+
+  Keyframe mandelbrot_keyframe(const double &scaling_factor,
+                               const double &center_real,
+                               const double &center_im,
+                               const Keyframe *previous = nullptr,
+                               const int &max_iterations =
+                                   board_max_iterations) {
+    /*
+      renders the keyframe (see Keyframe) of the frame of mandelbrot_board
+      with the given scaling factor, its samples twice as close as the
+      pixels of that frame, so that every frame down to half its scaling
+      factor is a downsampling of it (see keyframe_frame)
+      previous: keyframe of twice the scaling factor around the same center,
+      whose iterations are copied on the samples it shares with this one, a
+      quarter of them, instead of iterated again
+
+      the samples are iterated in double, or in double-double when they are
+      closer than double_spacing, as in mandelbrot_board
+     */
+    const int dim = getDimension();
+    Keyframe key;
+    key.spacing = 0.5 * boundries(scaling_factor).real();
+    // the frame of scaling_factor spans 2.48 scaling_factor = 2 (dim - 1)
+    // spacings, its center at 2 / 2.48 of its width from the left
+    key.left = static_cast<int>(std::ceil(2.0 * (dim - 1) / 1.24));
+    key.right = static_cast<int>(std::ceil(0.48 * (dim - 1) / 1.24));
+    key.half_height = static_cast<int>(std::ceil(1.13 * (dim - 1) / 1.24));
+    const int columns = key.columns();
+    key.iterations.resize(static_cast<std::size_t>(columns) * key.rows());
+    const bool reuse = previous != nullptr &&
+                       previous->spacing == 2.0 * key.spacing &&
+                       previous->left == key.left &&
+                       previous->right == key.right &&
+                       previous->half_height == key.half_height;
+    const bool double_double = key.spacing < double_spacing;
+
+    parallel_jobs(key.rows(), [&](const int &row) {
+      const int j = row - key.half_height;
+      std::vector<int> fresh;
+      for (int i = -key.left; i <= key.right; ++i) {
+        int &sample = key.iterations[row * columns + i + key.left];
+        if (reuse && i % 2 == 0 && j % 2 == 0) {
+          // i spacing and (i / 2) (2 spacing) are the same double
+          sample = previous->iterations[(j / 2 + key.half_height) * columns +
+                                        i / 2 + key.left];
+        } else if (!double_double) {
+          sample = num_iter(0.0,
+                            std::complex<double>(center_real + i * key.spacing,
+                                                 center_im + j * key.spacing),
+                            max_iterations);
+        } else {
+          fresh.push_back(i);
+        }
+      }
+      const int lanes = double_double_lanes;
+      DoubleDouble zero[lanes], c_real[lanes], c_im[lanes];
+      int iterations[lanes];
+      const DoubleDouble im = center_im + two_prod(j, key.spacing);
+      for (std::size_t first = 0; first < fresh.size(); first += lanes) {
+        for (int l = 0; l < lanes; ++l) {
+          // the lanes past the end of the row repeat its last sample
+          const int i = fresh[std::min(first + l, fresh.size() - 1)];
+          c_real[l] = center_real + two_prod(i, key.spacing);
+          c_im[l] = im;
+        }
+        num_iter_double_double_lanes<lanes>(zero, zero, c_real, c_im,
+                                            iterations, max_iterations);
+        for (int l = 0; l < lanes && first + l < fresh.size(); ++l) {
+          key.iterations[row * columns + fresh[first + l] + key.left] =
+              iterations[l];
+        }
+      }
+    });
+
+    const int samples = columns * key.rows();
+    key.reused = reuse ? (key.left / 2 + key.right / 2 + 1) *
+                             (2 * (key.half_height / 2) + 1)
+                       : 0;
+    key.iterated = samples - key.reused;
+    return key;
+  }
+
+  std::vector<double> keyframe_frame(const Keyframe &key,
+                                     const double &scaling_factor,
+                                     const int &max_iterations =
+                                         board_max_iterations) {
+    /*
+      frame of mandelbrot_board(scaling_factor, ...) around the center of a
+      keyframe, for scaling factors between the one of the keyframe and half
+      of it: each pixel is the average of the samples around it weighted by
+      a tent as wide as two pixels, a downsampling that blurs the aliasing of
+      single samples instead of keeping it
+     */
+    const int dim = getDimension();
+    const std::complex<double> bounds = boundries(scaling_factor);
+    // weights of the samples of each column and row of the frame, the tent
+    // being separable the two passes are done one after the other
+    struct Taps {
+      int first;
+      std::vector<double> weights;
+    };
+    auto taps = [&](const double &offset, const double &pixel, const int &low,
+                    const int &high) {
+      const double radius = std::max(pixel, key.spacing);
+      const int first = std::max(
+          low, static_cast<int>(std::floor((offset - radius) / key.spacing)));
+      const int last = std::min(
+          high, static_cast<int>(std::ceil((offset + radius) / key.spacing)));
+      Taps tap{first, {}};
+      double total = 0.0;
+      for (int k = first; k <= last; ++k) {
+        const double weight = std::max(
+            0.0, 1.0 - std::abs(k * key.spacing - offset) / radius);
+        tap.weights.push_back(weight);
+        total += weight;
+      }
+      for (double &weight : tap.weights) {
+        weight /= total;
+      }
+      return tap;
+    };
+    std::vector<Taps> column_taps, row_taps;
+    for (int x = 0; x < dim; ++x) {
+      column_taps.push_back(taps(x * bounds.real() - 2.0 * scaling_factor,
+                                 bounds.real(), -key.left, key.right));
+    }
+    for (int y = 0; y < dim; ++y) {
+      row_taps.push_back(taps(y * bounds.imag() - 1.13 * scaling_factor,
+                              bounds.imag(), -key.half_height,
+                              key.half_height));
+    }
+
+    const int columns = key.columns();
+    std::vector<double> rows(static_cast<std::size_t>(key.rows()) * dim);
+    for (int row = 0; row < key.rows(); ++row) {
+      for (int x = 0; x < dim; ++x) {
+        const Taps &tap = column_taps[x];
+        double color = 0.0;
+        for (std::size_t k = 0; k < tap.weights.size(); ++k) {
+          const int sample =
+              key.iterations[row * columns + tap.first + k + key.left];
+          color += tap.weights[k] *
+                   (1.0 - sample / static_cast<double>(max_iterations));
+        }
+        rows[row * dim + x] = color;
+      }
+    }
+    std::vector<double> board(dim * dim, 1.0);
+    for (int y = 0; y < dim; ++y) {
+      const Taps &tap = row_taps[y];
+      for (int x = 0; x < dim; ++x) {
+        double color = 0.0;
+        for (std::size_t k = 0; k < tap.weights.size(); ++k) {
+          color += tap.weights[k] *
+                   rows[(tap.first + k + key.half_height) * dim + x];
+        }
+        board[y * dim + x] = color;
+      }
+    }
+    return board;
+  }
+
+  std::vector<Keyframe> mandelbrot_keyframe_images(
+      const double &end_scaling_factor, const double &step,
+      const double &zoom_center_real, const double &zoom_center_im) {
+    /*
+      same frames and files as mandelbrot_multiple_images, downsampled from
+      one keyframe per halving of the scaling factor (see
+      mandelbrot_keyframe) instead of rendered one by one: each keyframe
+      iterates three quarters of four frames, whatever the number of frames
+      between two keyframes, and the frames are antialiased by the
+      downsampling
+      the frames of a keyframe are written several at a time, and logged to
+      std::cout in zoom order
+
+      returns the keyframes without their samples, to tell how many samples
+      each one iterated and reused
+    */
+    const std::vector<double> scaling_factors =
+        linear_scaling_factors(end_scaling_factor, step);
+    std::vector<Keyframe> keyframes;
+    if (scaling_factors.empty()) {
+      return keyframes;
+    }
+
+    // the first keyframe is the frame the zoom starts from
+    double key_factor = 3.0;
+    Keyframe key;
+    std::size_t frame = 0;
+    bool chained = false; // key is the keyframe of twice key_factor
+    while (frame < scaling_factors.size()) {
+      // frames down to half the scaling factor, the ones of scaling factor
+      // 0 or below with the last keyframe
+      std::size_t end = frame;
+      while (end < scaling_factors.size() &&
+             (scaling_factors[end] > 0.5 * key_factor ||
+              scaling_factors[end] <= 0.0)) {
+        end += 1;
+      }
+      if (end == frame) {
+        // no frame for this keyframe: the next one iterates all its samples
+        // rather than three quarters of two keyframes
+        key_factor *= 0.5;
+        chained = false;
+        continue;
+      }
+      key = mandelbrot_keyframe(key_factor, zoom_center_real, zoom_center_im,
+                                chained ? &key : nullptr);
+      chained = true;
+      parallel_jobs(end - frame, [&](const int &job) {
+        const double factor = scaling_factors[frame + job];
+        write_board(keyframe_frame(key, factor), getDimension(),
+                    std::to_string(factor), this->data_dir);
+      });
+      const Engine engine = key.spacing < double_spacing
+                                ? Engine::DoubleDouble
+                                : Engine::Double;
+      for (; frame < end; ++frame) {
+        std::cout << frame_log({static_cast<int>(frame),
+                                scaling_factors[frame], engine})
+                  << "\n";
+      }
+      keyframes.push_back(key);
+      keyframes.back().iterations.clear();
+      key_factor *= 0.5;
+    }
+    setBoard(keyframe_frame(key, scaling_factors.back()));
+    return keyframes;
+  }
+
+  std::vector<double> mandelbrot_rotated_board(const double &scaling_factor,
+                                               const double &center_real,
+                                               const double &center_im,
+                                               const double &rotation,
+                                               const int &max_iterations,
+                                               const bool &double_double,
+                                               const bool &parallel = false) {
+    /*
+      frame of mandelbrot_board turned by rotation radians counterclockwise
+      around (center_real, center_im): each pixel is at its offset from the
+      center rotated, in double or, when double_double, added to the center
+      in double-double, which keeps the frame sharp as deep as
+      mandelbrot_board
+      parallel: split the rows among the shared pool, only for frames not
+      already rendered by a job of the pool
+     */
+    const int dim = getDimension();
+    const std::complex<double> bounds = boundries(scaling_factor);
+    const std::complex<double> turn = std::polar(1.0, rotation);
+    std::vector<double> board(dim * dim, 1.0);
+    auto render_row = [&](const int &y) {
+      const int lanes = double_double_lanes;
+      DoubleDouble zero[lanes], c_real[lanes], c_im[lanes];
+      int iterations[lanes];
+      for (int x0 = 0; x0 < dim; x0 += lanes) {
+        for (int l = 0; l < lanes; ++l) {
+          // the lanes past the end of the row repeat its last pixel
+          const int x = std::min(x0 + l, dim - 1);
+          const std::complex<double> offset =
+              turn * std::complex<double>(
+                         x * bounds.real() - 2.0 * scaling_factor,
+                         y * bounds.imag() - 1.13 * scaling_factor);
+          if (double_double) {
+            c_real[l] = two_sum(center_real, offset.real());
+            c_im[l] = two_sum(center_im, offset.imag());
+          } else if (x == x0 + l) {
+            iterations[l] = num_iter(
+                0.0,
+                std::complex<double>(center_real, center_im) + offset,
+                max_iterations);
+          }
+        }
+        if (double_double) {
+          num_iter_double_double_lanes<lanes>(zero, zero, c_real, c_im,
+                                              iterations, max_iterations);
+        }
+        for (int l = 0; l < lanes && x0 + l < dim; ++l) {
+          board[y * dim + x0 + l] =
+              1.0 - iterations[l] / static_cast<double>(max_iterations);
+        }
+      }
+    };
+    if (parallel) {
+      parallel_jobs(dim, render_row);
+    } else {
+      for (int y = 0; y < dim; ++y) {
+        render_row(y);
+      }
+    }
+    return board;
+  }
+
+  std::vector<CameraFrame> mandelbrot_camera_plan(
+      const std::vector<CameraKey> &path, const int &num_frames,
+      const int &max_iterations) {
+    /*
+      frames of a camera path (see camera_at) evenly spaced in time from its
+      first key to its last one, each with the cheapest engine that resolves
+      it (see mandelbrot_engine) and an estimate of its cost: the pixels,
+      times the mean iterations of a few probe pixels for the frames double
+      resolves or max_iterations for deeper ones, times the cost of an
+      iteration of the engine (engine_cost)
+
+      rotated frames are rendered by the escape-time engines, double and
+      double-double (see mandelbrot_rotated_board), whose pixels can be
+      anywhere: they lose their detail past double_double_spacing
+    */
+    const int dim = getDimension();
+    const int probes = 8;
+    std::vector<CameraFrame> plans;
+    for (int frame = 0; frame < num_frames; ++frame) {
+      const double time =
+          num_frames == 1
+              ? path.front().time
+              : path.front().time + (path.back().time - path.front().time) *
+                                        frame / (num_frames - 1);
+      const CameraKey camera = camera_at(path, time);
+      Engine engine = mandelbrot_engine(camera.scaling_factor, max_iterations);
+      if (camera.rotation != 0.0) {
+        engine = std::clamp(engine, Engine::Double, Engine::DoubleDouble);
+      }
+      double mean_iterations = max_iterations;
+      if (engine <= Engine::Double) {
+        const double factor = static_cast<double>(camera.scaling_factor);
+        mean_iterations = 0.0;
+        for (int y = 0; y < probes; ++y) {
+          for (int x = 0; x < probes; ++x) {
+            const std::complex<double> offset(
+                (x + 0.5) / probes * 2.48 * factor - 2.0 * factor,
+                (y + 0.5) / probes * 2.26 * factor - 1.13 * factor);
+            mean_iterations +=
+                num_iter(0.0,
+                         std::complex<double>(camera.center_real,
+                                              camera.center_im) +
+                             offset,
+                         max_iterations);
+          }
+        }
+        mean_iterations /= probes * probes;
+      }
+      plans.push_back({frame, camera, engine,
+                       static_cast<double>(dim) * dim *
+                           std::max(1.0, mean_iterations) *
+                           engine_cost(engine)});
+    }
+    return plans;
+  }
+
+  std::vector<double> mandelbrot_camera_board(const CameraFrame &plan,
+                                              const int &max_iterations) {
+    // renders a planned frame of a camera path with its engine
+    const CameraKey &camera = plan.camera;
+    if (camera.rotation != 0.0) {
+      return mandelbrot_rotated_board(
+          static_cast<double>(camera.scaling_factor), camera.center_real,
+          camera.center_im, camera.rotation, max_iterations,
+          plan.engine == Engine::DoubleDouble);
+    }
+    return mandelbrot_engine_board(plan.engine, camera.scaling_factor,
+                                   camera.center_real, camera.center_im,
+                                   max_iterations);
+  }
+
+  std::vector<CameraFrame> mandelbrot_camera_images(
+      const std::vector<CameraKey> &path, const int &num_frames,
+      const int &max_iterations,
+      const std::size_t &memory_budget = default_memory_budget) {
+    /*
+      renders num_frames frames of a camera path (see
+      mandelbrot_camera_plan), several at a time, the most expensive first
+      so that the last ones to finish are the cheap ones and the workers of
+      the pool are busy until the end
+      memory_budget: bytes that frames rendered in parallel may occupy before
+      being written
+
+      the frames are called by their number and scaling factor, logged to
+      std::cout as they are written, most expensive first; returns the plan.
+      The center of a path moves, so every perturbation frame computes its
+      own reference
+    */
+    const std::vector<CameraFrame> plans =
+        mandelbrot_camera_plan(path, num_frames, max_iterations);
+    std::vector<int> order(plans.size());
+    for (std::size_t frame = 0; frame < plans.size(); ++frame) {
+      order[frame] = static_cast<int>(frame);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](const int &a, const int &b) {
+                       return plans[a].cost > plans[b].cost;
+                     });
+
+    const int dim = getDimension();
+    const int max_in_flight =
+        jobs_in_flight(memory_budget, dim * dim * sizeof(double));
+    ordered_parallel_jobs(
+        plans.size(), max_in_flight,
+        [&](const int &job) {
+          return mandelbrot_camera_board(plans[order[job]], max_iterations);
+        },
+        [&](const int &job, std::vector<double> board) {
+          const CameraFrame &plan = plans[order[job]];
+          std::cout << frame_log({plan.frame, plan.camera.scaling_factor,
+                                  plan.engine})
+                    << "\n";
+          write_board(board, dim,
+                      sequence_name(plan.frame, plan.camera.scaling_factor),
+                      this->data_dir);
+          if (plan.frame + 1 == static_cast<int>(plans.size())) {
+            setBoard(std::move(board));
+          }
+        });
+    return plans;
+  }
+
+  std::vector<double> mandelbrot_deep_board(const double &scaling_factor,
+                                            const double &center_real,
+                                            const double &center_im,
+                                            const int &max_iterations,
+                                            const bool &parallel = false,
+                                            ReferenceCache *cache = nullptr) {
+    /*
+      renders the mandelbrot set by perturbation (see deep_zoom.h) around the
+      reference orbit of the zoom center, glitches corrected with more
+      references, so that scaling factors far below 1e-13 keep their detail;
+      the frame covers the same region as mandelbrot_board. The first
+      reference is the nucleus of lowest period in the frame, if any
+      scaling_factor: it's the level of zoom on the image
+      center_real: where the image is centered on the real axis
+      center_im: where the image is centered on the imaginary axis
+      max_iterations: iterations after which a point is considered bounded,
+      deep frames need many more than the 300 of board_gen
+      parallel: split the rows among the shared pool, only for frames not
+      already rendered by a job of the pool
+      cache: if not nullptr, gives the orbit of the center, shared with the
+      other frames of a zoom toward it
+     */
+    const int dim = getDimension();
+    const double real_bound = boundries(scaling_factor).real();
+    const double im_bound = boundries(scaling_factor).imag();
+    // pixel (0, 0) with respect to the center, as in mandelbrot_board
+    const std::complex<double> corner(-2.0 * scaling_factor,
+                                      -1.13 * scaling_factor);
+    std::vector<double> board(dim * dim, 1.0);
+    perturbation_board(board, dim, real_bound, im_bound, corner, center_real,
+                       center_im, max_iterations, parallel, true, true, 0,
+                       cache, true);
+    return board;
+  }
+
+  std::vector<double> mandelbrot_deep_board(const FloatExp &scaling_factor,
+                                            const double &center_real,
+                                            const double &center_im,
+                                            const int &max_iterations,
+                                            const bool &parallel = false,
+                                            ReferenceCache *cache = nullptr) {
+    /*
+      same as mandelbrot_deep_board for scaling factors out of the range of
+      double (below about 1e-290): the frame is described in units of
+      2**scaling_factor.getExponent() and its pixels iterate rescaled
+      (see rescaled_iterations) until their deltas fit in double
+     */
+    if (scaling_factor.getExponent() > rescaled_exponent) {
+      return mandelbrot_deep_board(static_cast<double>(scaling_factor),
+                                   center_real, center_im, max_iterations,
+                                   parallel, cache);
+    }
+    const int dim = getDimension();
+    const int scale_exponent = scaling_factor.getExponent();
+    const double scaled_factor = scaling_factor.getMantissa();
+    const double real_bound = boundries(scaled_factor).real();
+    const double im_bound = boundries(scaled_factor).imag();
+    const std::complex<double> corner(-2.0 * scaled_factor,
+                                      -1.13 * scaled_factor);
+    std::vector<double> board(dim * dim, 1.0);
+    perturbation_board(board, dim, real_bound, im_bound, corner, center_real,
+                       center_im, max_iterations, parallel, true, true,
+                       scale_exponent, cache, true);
+    return board;
+  }
+
+  void mandelbrot_deep_generator(const FloatExp &scaling_factor,
+                                 const double &center_real,
+                                 const double &center_im,
+                                 const int &max_iterations) {
+    /*
+      same as mandelbrot_generator for any scaling factor, the frame is
+      rendered by mandelbrot_deep_board and saved with its scaling factor in
+      scientific notation
+     */
+    setBoard(mandelbrot_deep_board(scaling_factor, center_real, center_im,
+                                   max_iterations, true));
+    save_to_file(scale_name(scaling_factor), this->data_dir);
+  }
+
+  std::vector<FrameRecord> mandelbrot_deep_multiple_images(
+      const FloatExp &end_scaling_factor, const double &zoom_ratio,
+      const double &zoom_center_real, const double &zoom_center_im,
+      const int &max_iterations,
+      const std::size_t &memory_budget = default_memory_budget,
+      const std::string &orbit_file = "") {
+    /*
+      generates a zoom toward (zoom_center_real, zoom_center_im), several
+      frames at a time, each rendered by the cheapest engine that resolves it
+      (see mandelbrot_engine): one job goes from float to rescaled
+      perturbation by itself
+      end_scaling_factor: last scaling factor before stopping zoom
+      zoom_ratio: scaling factor of a frame over the one of the previous
+      frame, between 0 and 1 (std::invalid_argument otherwise): the zoom
+      speed is the same at every depth
+      max_iterations: iterations after which a point is considered bounded
+      memory_budget: bytes that frames rendered in parallel may occupy before
+      being written
+      orbit_file: if not empty, file keeping the orbit of the zoom center
+      for the next runs (see ReferenceCache)
+
+      the perturbation frames share one orbit of the zoom center, computed
+      once for the deepest of them; the frames are called by their number
+      and scaling factor, that can go past the range of double; the engine of
+      each frame is logged to std::cout as it is written, and returned
+    */
+    if (!(zoom_ratio > 0.0 && zoom_ratio < 1.0)) {
+      // the zoom would never reach end_scaling_factor
+      throw std::invalid_argument("zoom_ratio must be between 0 and 1");
+    }
+    std::vector<FloatExp> scaling_factors;
+    FloatExp scaling_factor = 3.0;
+    while (scaling_factor > end_scaling_factor) {
+      scaling_factor = scaling_factor * zoom_ratio;
+      scaling_factors.push_back(scaling_factor);
+    }
+
+    std::vector<FrameRecord> records;
+    for (std::size_t frame = 0; frame < scaling_factors.size(); ++frame) {
+      records.push_back(
+          {static_cast<int>(frame), scaling_factors[frame],
+           mandelbrot_engine(scaling_factors[frame], max_iterations)});
+    }
+    ReferenceCache cache(zoom_center_real, zoom_center_im, orbit_file);
+    share_reference(cache, records, max_iterations);
+
+    const int dim = getDimension();
+    const int max_in_flight =
+        jobs_in_flight(memory_budget, dim * dim * sizeof(double));
+    ordered_parallel_jobs(
+        scaling_factors.size(), max_in_flight,
+        [&](const int &frame) {
+          return mandelbrot_engine_board(records[frame].engine,
+                                         scaling_factors[frame],
+                                         zoom_center_real, zoom_center_im,
+                                         max_iterations, &cache);
+        },
+        [&](const int &frame, std::vector<double> board) {
+          std::cout << frame_log(records[frame]) << "\n";
+          write_board(board, dim,
+                      sequence_name(frame, scaling_factors[frame]),
+                      this->data_dir);
+          if (frame + 1 == static_cast<int>(scaling_factors.size())) {
+            setBoard(std::move(board));
+          }
+        });
+    return records;
+  }
+};
+
+struct JuliaFrameReport {
+  // how a frame of a julia sweep has been produced
+  std::complex<double> c; // complex constant of the frame
+  int source;    // earlier frame whose board was reused, -1 if rendered
+  bool mirrored; // the reused board was flipped, c is the conjugate of its c
+  JuliaClassification classification; // how the frame was rendered
+};
+
+class Julia : public Fractals {
+  // class that inherits from Fractals
+  // creates and renders the  julia sets
+private:
+  std::string data_dir;
+public:
+  Julia(int dim) : Fractals(dim), data_dir("JULIA") { smkdir(this->data_dir); }
+
+  static std::string frame_name(const std::complex<double> &c) {
+    // the file in which a julia set is stored is called as its c
+    return std::to_string(c.real()) + "_" + std::to_string(c.imag());
+  }
+
+  std::vector<double> julia_board(
+      const std::complex<double> &c,
+      const JuliaClassification *classification = nullptr) {
+    /*
+      renders the julia set of c on the square [-2, 2]^2 into a new board,
+      with cycle detection if classify_julia says it pays off
+      c: complex constant associated to the julia set generated
+      classification: classify_julia(c) if the caller already has it,
+      computed here if nullptr
+    */
     const double unscaled_real_domain = 4;
     const double unscaled_im_domain = 4;
 
@@ -212,13 +2384,468 @@ public:
     double center_real = -2.0;
     double center_im = -2.0;
 
-    board_gen(real_bound, im_bound, center_real, center_im, c, julia_mode);
-    std::string filename =
-        std::to_string(c.real()) + "_" + std::to_string(c.imag());
-    save_to_file(filename, this->data_dir);
+    std::vector<double> board(getDimension() * getDimension(), 1.0);
+    bool julia_mode = false; // sets the mode to Julia
+    const bool check_period = classification != nullptr
+                                  ? classification->check_periodicity
+                                  : classify_julia(c).check_periodicity;
+    fill_board(board, getDimension(), real_bound, im_bound, center_real,
+               center_im, c, julia_mode, check_period);
+    return board;
+  }
+
+  LazyFrame julia_lazy_frame(const std::complex<double> &c,
+                             const int &tile = lazy_tile) {
+    // board of julia_board(c) whose tiles are rendered when read
+    const double bound = 4.0 / (getDimension() - 1);
+    return LazyFrame({bound, bound, -2.0, -2.0, c, false,
+                      classify_julia(c).check_periodicity},
+                     getDimension(), tile);
+  }
+
+  static void fill_julia_batch(const int &dim, const std::complex<double> *cs,
+                               const int &count, double *const *boards,
+                               const int &row_stride) {
+    /*
+      renders the julia sets of up to julia_batch_lanes constants in a single
+      pass over the [-2, 2]^2 grid: every starting point is loaded once and
+      iterated for all the constants together by num_iter_lanes
+      dim: dimension of each board
+      cs: complex constants of the boards
+      count: how many constants are in cs (at most julia_batch_lanes)
+      boards: where the top left pixel of each board goes
+      row_stride: distance between two rows of a board, dim for standalone
+      boards, more when the boards are tiles of a bigger image
+    */
+    const int max_iterations = board_max_iterations;
+    const double real_bound = 4.0 / (dim - 1);
+    const double im_bound = 4.0 / (dim - 1);
+    double center_real = -2.0;
+    double center_im = -2.0;
+
+    // unused lanes repeat the last constant and are thrown away
+    double c_real[julia_batch_lanes];
+    double c_im[julia_batch_lanes];
+    bool check_period[julia_batch_lanes];
+    for (int l = 0; l < julia_batch_lanes; ++l) {
+      const std::complex<double> &c = cs[std::min(l, count - 1)];
+      c_real[l] = c.real();
+      c_im[l] = c.imag();
+      check_period[l] = classify_julia(c).check_periodicity;
+    }
+
+    int iterations[julia_batch_lanes];
+    for (int x = 0; x < dim; ++x) {
+      for (int y = 0; y < dim; ++y) {
+        double real = x * real_bound + center_real;
+        double im = y * im_bound + center_im;
+        num_iter_lanes<julia_batch_lanes>(std::complex<double>(real, im),
+                                          c_real, c_im, iterations,
+                                          max_iterations, 4, check_period);
+        for (int l = 0; l < count; ++l) {
+          boards[l][y * row_stride + x] =
+              1.0 - iterations[l] / static_cast<double>(max_iterations);
+        }
+      }
+    }
+  }
+
+  std::vector<std::vector<double>>
+  julia_batch_boards(const std::complex<double> *cs, const int &count) {
+    /*
+      renders the julia sets of up to julia_batch_lanes constants at once with
+      fill_julia_batch
+      cs: complex constants of the boards
+      count: how many constants are in cs (at most julia_batch_lanes)
+
+      returns one board per constant, identical to the ones of julia_board
+    */
+    const int dim = getDimension();
+    std::vector<std::vector<double>> boards(
+        count, std::vector<double>(dim * dim, 1.0));
+    double *outputs[julia_batch_lanes];
+    for (int l = 0; l < count; ++l) {
+      outputs[l] = boards[l].data();
+    }
+    fill_julia_batch(dim, cs, count, outputs, dim);
+    return boards;
+  }
+
+  std::vector<double> julia_atlas(const std::complex<double> &c_min,
+                                  const std::complex<double> &c_max,
+                                  const int &columns, const int &rows,
+                                  const int &thumbnail_dim,
+                                  const std::string &filename = "atlas") {
+    /*
+      renders a map of julia sets: a grid of rows x columns thumbnails, the
+      one in column i and row j showing the julia set of
+      c = c_min + (i * (c_max - c_min).real / (columns - 1),
+                   j * (c_max - c_min).imag / (rows - 1))
+      all the thumbnails are rendered in one parallel batch straight into a
+      single image, which is saved in the julia directory
+      c_min, c_max: corners of the region of c covered by the atlas
+      columns, rows: number of thumbnails along the real and imaginary axis
+      thumbnail_dim: dimension of each thumbnail
+      filename: name of the file of the atlas
+
+      returns the atlas, columns * thumbnail_dim pixels wide
+    */
+    const int width = columns * thumbnail_dim;
+    const int height = rows * thumbnail_dim;
+    const double c_real_step =
+        columns > 1 ? (c_max.real() - c_min.real()) / (columns - 1) : 0.0;
+    const double c_im_step =
+        rows > 1 ? (c_max.imag() - c_min.imag()) / (rows - 1) : 0.0;
+    std::vector<double> atlas(width * height, 1.0);
+
+    const int num_thumbnails = columns * rows;
+    const int num_batches =
+        (num_thumbnails + julia_batch_lanes - 1) / julia_batch_lanes;
+    parallel_jobs(num_batches, [&](const int &batch) {
+      std::complex<double> cs[julia_batch_lanes];
+      double *outputs[julia_batch_lanes];
+      const int first = batch * julia_batch_lanes;
+      const int count =
+          std::min(julia_batch_lanes, num_thumbnails - first);
+      for (int l = 0; l < count; ++l) {
+        const int column = (first + l) % columns;
+        const int row = (first + l) / columns;
+        cs[l] = std::complex<double>(c_min.real() + column * c_real_step,
+                                     c_min.imag() + row * c_im_step);
+        outputs[l] =
+            &atlas[row * thumbnail_dim * width + column * thumbnail_dim];
+      }
+      fill_julia_batch(thumbnail_dim, cs, count, outputs, width);
+    });
+
+    write_image(atlas, width, height, filename, this->data_dir);
+    return atlas;
+  }
+
+  std::complex<double> boundries(const double &scaling_factor) const {
+    /*
+      distance between two pixels of a julia frame: the frame is the square
+      of side 4 * scaling_factor around its center, [-2, 2]^2 for a scaling
+      factor of 1 around 0
+    */
+    const double bound = 4.0 * scaling_factor / (getDimension() - 1);
+    return std::complex<double>(bound, bound);
+  }
+
+  Engine julia_engine(const FloatExp &scaling_factor,
+                      const int &max_iterations) {
+    /*
+      engine of the precision ladder for a julia frame (see ladder_engine),
+      from double up: there is no float kernel for julia sets
+    */
+    return ladder_engine(
+        scaling_factor, boundries(static_cast<double>(scaling_factor)).real(),
+        max_iterations, Engine::Double);
+  }
+
+  std::vector<double> julia_engine_board(const Engine &engine,
+                                         const std::complex<double> &c,
+                                         const FloatExp &scaling_factor,
+                                         const double &center_real,
+                                         const double &center_im,
+                                         const int &max_iterations,
+                                         const bool &parallel = false,
+                                         const JuliaClassification
+                                             *classification = nullptr) {
+    /*
+      renders the julia set of c on the frame of a given scaling factor
+      around (center_real, center_im) with a given engine
+      parallel: split the rows of a perturbation frame among the shared
+      pool, only for frames not already rendered by a job of the pool
+      classification: as in julia_board(c), used by the double engine
+
+      with the double engine the frame of scaling factor 1 around 0 is the
+      board of julia_board(c)
+    */
+    const int dim = getDimension();
+    std::vector<double> board(dim * dim, 1.0);
+    const bool julia_mode = false;
+    if (engine == Engine::PerturbationFloatExp) {
+      // in units of 2**scale_exponent (see julia_perturbation_board)
+      const int scale_exponent = scaling_factor.getExponent();
+      const double scaled_factor = scaling_factor.getMantissa();
+      const double bound = boundries(scaled_factor).real();
+      julia_perturbation_board(board, dim, bound, bound,
+                               {-2.0 * scaled_factor, -2.0 * scaled_factor},
+                               center_real, center_im, c, max_iterations,
+                               parallel, true, scale_exponent);
+      return board;
+    }
+    const double factor = static_cast<double>(scaling_factor);
+    const double bound = boundries(factor).real();
+    if (engine == Engine::Perturbation) {
+      julia_perturbation_board(board, dim, bound, bound,
+                               {-2.0 * factor, -2.0 * factor}, center_real,
+                               center_im, c, max_iterations, parallel);
+    } else if (engine == Engine::DoubleDouble) {
+      fill_board(board, dim, bound, bound, two_sum(center_real, -2.0 * factor),
+                 two_sum(center_im, -2.0 * factor), c, julia_mode,
+                 max_iterations);
+    } else {
+      const bool check_period = classification != nullptr
+                                    ? classification->check_periodicity
+                                    : classify_julia(c).check_periodicity;
+      fill_board(board, dim, bound, bound, center_real - 2.0 * factor,
+                 center_im - 2.0 * factor, c, julia_mode, check_period,
+                 max_iterations);
+    }
+    return board;
+  }
+
+  std::vector<double> julia_board(const std::complex<double> &c,
+                                  const FloatExp &scaling_factor,
+                                  const double &center_real,
+                                  const double &center_im,
+                                  const int &max_iterations =
+                                      board_max_iterations,
+                                  const JuliaClassification *classification =
+                                      nullptr) {
+    /*
+      renders the julia set of c on the square of side 4 * scaling_factor
+      around (center_real, center_im), with the cheapest engine that resolves
+      it (see julia_engine): julia sets zoom as deep as the mandelbrot set
+      max_iterations: iterations after which a point is considered bounded,
+      deep frames need more than the 300 of julia_board(c)
+      classification: as in julia_board(c)
+    */
+    return julia_engine_board(julia_engine(scaling_factor, max_iterations), c,
+                              scaling_factor, center_real, center_im,
+                              max_iterations, true, classification);
+  }
+
+  JuliaClassification julia_generator(const std::complex<double> &c) {
+    /*
+      generates a single julia set for a given c complex constant
+      c: complex constant associated to the julia set generated
+
+      returns the classification of the julia set (see classify_julia)
+    */
+    const JuliaClassification classification = classify_julia(c);
+    setBoard(julia_board(c, &classification));
+    const double bound = 4.0 / (getDimension() - 1);
+    setViewport({bound, bound, -2.0, -2.0, c, false,
+                 classification.check_periodicity});
+    save_to_file(frame_name(c), this->data_dir);
+    return classification;
+  }
+
+  JuliaClassification julia_generator(const std::complex<double> &c,
+                                      const FloatExp &scaling_factor,
+                                      const double &center_real,
+                                      const double &center_im,
+                                      const int &max_iterations =
+                                          board_max_iterations) {
+    /*
+      same as julia_generator on the frame of julia_board(c, scaling_factor,
+      center_real, center_im), the file is named by c and the scaling factor
+    */
+    const JuliaClassification classification = classify_julia(c);
+    setBoard(julia_board(c, scaling_factor, center_real, center_im,
+                         max_iterations, &classification));
+    save_to_file(frame_name(c) + "_" + scale_name(scaling_factor),
+                 this->data_dir);
+    return classification;
+  }
+
+  static std::vector<double> mirror_board(const std::vector<double> &board,
+                                          const int &dim) {
+    /*
+      flips a board upside down: J(conj(c)) is the mirror image of J(c) with
+      respect to the real axis, which is the middle row of the julia grid
+    */
+    std::vector<double> mirrored(board.size());
+    for (int y = 0; y < dim; ++y) {
+      std::copy(board.begin() + (dim - 1 - y) * dim,
+                board.begin() + (dim - y) * dim, mirrored.begin() + y * dim);
+    }
+    return mirrored;
+  }
+
+  static std::vector<JuliaFrameReport>
+  plan_julia_sequence(const std::vector<std::complex<double>> &cs,
+                      const int &memo_capacity) {
+    /*
+      decides which frames of a sweep are rendered and which ones reuse the
+      board of an earlier frame with the same c (copied) or with the conjugate
+      c (mirrored)
+      memo_capacity: how many rendered boards can be kept around waiting for
+      the frames reusing them, the least recently used ones are forgotten
+    */
+    std::vector<JuliaFrameReport> plan;
+    std::list<int> memo; // rendered frames, most recently used first
+    for (int i = 0; i < static_cast<int>(cs.size()); ++i) {
+      JuliaFrameReport report = {cs[i], -1, false, classify_julia(cs[i])};
+      for (auto it = memo.begin(); it != memo.end(); ++it) {
+        if (cs[*it] == cs[i] || cs[*it] == std::conj(cs[i])) {
+          report.source = *it;
+          report.mirrored = cs[*it] != cs[i];
+          memo.splice(memo.begin(), memo, it);
+          break;
+        }
+      }
+      if (report.source < 0 && memo_capacity > 0) {
+        memo.push_front(i);
+        if (static_cast<int>(memo.size()) > memo_capacity) {
+          memo.pop_back();
+        }
+      }
+      plan.push_back(report);
+    }
+    return plan;
+  }
+
+  std::vector<JuliaFrameReport>
+  julia_sequence(const std::vector<std::complex<double>> &cs,
+                 const std::size_t &memory_budget = default_memory_budget) {
+    /*
+      generates one julia set per complex constant, rendering several of them
+      at the same time on the shared pool, julia_batch_lanes frames per job
+      with julia_batch_boards
+      frames whose c (or its conjugate) was already rendered in the sweep are
+      copied (or mirrored) from that frame instead of being computed again
+      cs: complex constants of the frames, in the order they are written
+      memory_budget: bytes that frames rendered in parallel, or kept to be
+      reused, may occupy before being written
+
+      returns how each frame was produced, with the classification of its
+      julia set
+    */
+    const int dim = getDimension();
+    const int num_frames = cs.size();
+    const std::size_t board_bytes = dim * dim * sizeof(double);
+    const int max_in_flight =
+        jobs_in_flight(memory_budget, julia_batch_lanes * board_bytes);
+    const int memo_capacity =
+        std::max(0, static_cast<int>(memory_budget / board_bytes) -
+                        max_in_flight * julia_batch_lanes);
+    std::vector<JuliaFrameReport> plan = plan_julia_sequence(cs, memo_capacity);
+
+    std::vector<int> rendered;
+    std::vector<int> pending_reuses(num_frames, 0);
+    for (int i = 0; i < num_frames; ++i) {
+      if (plan[i].source < 0) {
+        rendered.push_back(i);
+      } else {
+        pending_reuses[plan[i].source] += 1;
+      }
+    }
+    std::map<int, std::vector<double>> kept;
+
+    const int num_batches =
+        (rendered.size() + julia_batch_lanes - 1) / julia_batch_lanes;
+    int next_to_write = 0;
+    ordered_parallel_jobs(
+        num_batches, max_in_flight,
+        [&](const int &batch) {
+          const int first = batch * julia_batch_lanes;
+          const int count = std::min<int>(julia_batch_lanes,
+                                          rendered.size() - first);
+          std::vector<std::complex<double>> batch_cs;
+          for (int l = 0; l < count; ++l) {
+            batch_cs.push_back(cs[rendered[first + l]]);
+          }
+          return julia_batch_boards(batch_cs.data(), count);
+        },
+        [&](const int &batch, std::vector<std::vector<double>> boards) {
+          // every frame before the first rendered frame of the next batch
+          // can be written: the frames it reuses are all rendered by now
+          const int next_batch = (batch + 1) * julia_batch_lanes;
+          const int write_until =
+              batch + 1 == num_batches ? num_frames : rendered[next_batch];
+          int lane = 0;
+          for (; next_to_write < write_until; ++next_to_write) {
+            const int frame = next_to_write;
+            const JuliaFrameReport &report = plan[frame];
+            std::vector<double> board;
+            if (report.source < 0) {
+              board = std::move(boards[lane++]);
+            } else {
+              const std::vector<double> &source = kept.at(report.source);
+              board = report.mirrored ? mirror_board(source, dim) : source;
+              if (--pending_reuses[report.source] == 0) {
+                kept.erase(report.source);
+              }
+            }
+            write_board(board, dim, frame_name(report.c), this->data_dir);
+            if (frame + 1 == num_frames) {
+              setBoard(std::move(board));
+            } else if (pending_reuses[frame] > 0) {
+              kept.emplace(frame, std::move(board));
+            }
+          }
+        });
+    return plan;
+  }
+
+  std::vector<FrameRecord> julia_zoom_multiple_images(
+      const std::complex<double> &c, const FloatExp &end_scaling_factor,
+      const double &zoom_ratio, const double &zoom_center_real,
+      const double &zoom_center_im, const int &max_iterations,
+      const std::size_t &memory_budget = default_memory_budget) {
+    /*
+      same as Mandelbrot::mandelbrot_deep_multiple_images for the julia set
+      of c: a zoom from the whole set (scaling factor 1) toward
+      (zoom_center_real, zoom_center_im), each frame rendered by the
+      cheapest engine that resolves it (see julia_engine), down to and past
+      the range of double
+      end_scaling_factor: last scaling factor before stopping zoom
+      zoom_ratio: scaling factor of a frame over the one of the previous
+      frame, between 0 and 1 (std::invalid_argument otherwise)
+      max_iterations: iterations after which a point is considered bounded
+      memory_budget: bytes that frames rendered in parallel may occupy before
+      being written
+
+      the frames are called by their number and scaling factor, the engine
+      of each frame is logged to std::cout as it is written, and returned
+    */
+    if (!(zoom_ratio > 0.0 && zoom_ratio < 1.0)) {
+      // the zoom would never reach end_scaling_factor
+      throw std::invalid_argument("zoom_ratio must be between 0 and 1");
+    }
+    std::vector<FloatExp> scaling_factors;
+    FloatExp scaling_factor = 1.0;
+    while (scaling_factor > end_scaling_factor) {
+      scaling_factor = scaling_factor * zoom_ratio;
+      scaling_factors.push_back(scaling_factor);
+    }
+
+    std::vector<FrameRecord> records;
+    for (std::size_t frame = 0; frame < scaling_factors.size(); ++frame) {
+      records.push_back(
+          {static_cast<int>(frame), scaling_factors[frame],
+           julia_engine(scaling_factors[frame], max_iterations)});
+    }
+
+    const int dim = getDimension();
+    const int max_in_flight =
+        jobs_in_flight(memory_budget, dim * dim * sizeof(double));
+    ordered_parallel_jobs(
+        scaling_factors.size(), max_in_flight,
+        [&](const int &frame) {
+          return julia_engine_board(records[frame].engine, c,
+                                    scaling_factors[frame], zoom_center_real,
+                                    zoom_center_im, max_iterations);
+        },
+        [&](const int &frame, std::vector<double> board) {
+          std::cout << frame_log(records[frame]) << "\n";
+          write_board(board, dim,
+                      sequence_name(frame, scaling_factors[frame]),
+                      this->data_dir);
+          if (frame + 1 == static_cast<int>(scaling_factors.size())) {
+            setBoard(std::move(board));
+          }
+        });
+    return records;
   }
 
-  void julia_multiple_images(const int &num_points, const double &step) {
+  void julia_multiple_images(const int &num_points, const double &step,
+                             const std::size_t &memory_budget =
+                                 default_memory_budget) {
     /*
       generates multiple images of julia sets by calling the generate julia
       function how the c constant changes is chosen arbitrarly, any other orbit
@@ -226,12 +2853,15 @@ public:
 
       num_points: number of images generated
       step: how much does the c constant changes between image generated
+      memory_budget: bytes that frames rendered in parallel may occupy before
+      being written
     */
+    std::vector<std::complex<double>> cs;
     for (int i = 0; i < num_points; ++i) {
       double real_c = 0.0 + i * step;
       double imag_c = 0.0 - i * step;
-      std::complex<double> c(real_c, imag_c);
-      julia_generator(c);
+      cs.emplace_back(real_c, imag_c);
     }
+    julia_sequence(cs, memory_budget);
   }
 };
@@ -21,7 +21,7 @@ int main() {
   mandelbrot.mandelbrot_generator(scaling_factor, center_real, center_im);
 
   // Example 2: Generate multiple Mandelbrot sets with different scaling factors
-  int end_scaling_factor =
+  double end_scaling_factor =
       0.3;           // Set the last scaling factor before stopping zoom
   double step = 0.1; // Set the step size for changing the scaling factor
   double zoom_center_real =
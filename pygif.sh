@@ -3,7 +3,7 @@ rm -r MANDELBROT
 
 rm -r JULIA
 
-g++ main.cpp
+g++ -O2 -pthread main.cpp
 
 ./a.out
 
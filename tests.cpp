@@ -1,8 +1,17 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
+#include <chrono>
+#include <future>
+
 #include "doctest.h"
 #include "fractals.h"
 
+// the asynchronous renders need coroutines (C++20), the rest of the tests
+// build as C++17
+#if defined(__cpp_impl_coroutine)
+#include "async_render.h"
+#endif
+
 TEST_CASE("num_iter") {
 
   // Tests for the num_iter function
@@ -302,3 +311,1638 @@ TEST_CASE("julia_multiple_images test") {
     }
   }
 }
+
+TEST_CASE("parallel sweeps") {
+  /*
+    tests that the sweeps rendering several frames at the same time produce
+    the same images as the single image generators, in particular:
+    - each frame equals the one rendered by the generator
+    - a memory budget smaller than a board still renders every frame
+  */
+  int dim = 60;
+
+  SUBCASE("julia_sequence matches julia_generator") {
+    std::vector<std::complex<double>> cs = {
+        {0.1, 0.2}, {-0.4, 0.6}, {0.285, 0.01}, {-0.8, 0.156}};
+    Julia sequence(dim);
+    Julia single(dim);
+    sequence.julia_sequence(cs);
+    for (const std::complex<double> &c : cs) {
+      const std::string file = "./JULIA/" + std::to_string(c.real()) + "_" +
+                               std::to_string(c.imag()) + ".ppm";
+      std::vector<uint8_t> written = readPPM(file);
+      single.julia_generator(c);
+      CHECK(written == readPPM(file));
+    }
+    // the object keeps the board of the last frame
+    CHECK(sequence.getBoard() == single.getBoard());
+  }
+
+  SUBCASE("memory budget of a single board") {
+    Mandelbrot parallel(dim);
+    Mandelbrot serial(dim);
+    const double step = 0.5;
+    parallel.mandelbrot_multiple_images(1, step, -0.74, 0.0, 1);
+    double scaling_factor = 3.0;
+    while (scaling_factor > 1) {
+      scaling_factor = scaling_factor - step;
+      std::vector<double> expected =
+          serial.mandelbrot_board(scaling_factor, -0.74, 0.0);
+      std::vector<uint8_t> written = readPPM(
+          "./MANDELBROT/" + std::to_string(scaling_factor) + ".ppm");
+      serial.mandelbrot_generator(scaling_factor, -0.74, 0.0);
+      CHECK(written == readPPM("./MANDELBROT/" +
+                               std::to_string(scaling_factor) + ".ppm"));
+      CHECK(serial.getBoard() == expected);
+    }
+    CHECK(parallel.getBoard() == serial.getBoard());
+  }
+
+  SUBCASE("a failing frame waits for the frames in flight") {
+    // the jobs read a local of the caller, which must outlive all of them
+    std::vector<int> values(64, 1);
+    std::atomic<int> finished(0);
+    CHECK_THROWS_AS(ordered_parallel_jobs(
+                        64, 8,
+                        [&](const int &job) {
+                          std::this_thread::sleep_for(
+                              std::chrono::milliseconds(2));
+                          finished += 1;
+                          return values[job];
+                        },
+                        [&](const int &job, int) {
+                          if (job == 2) {
+                            throw std::runtime_error("write failed");
+                          }
+                        }),
+                    std::runtime_error);
+    const int started = finished.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(finished.load() == started);
+  }
+}
+
+TEST_CASE("batch julia kernel") {
+  /*
+    the batch kernel iterates several complex constants at once, it has to
+    give exactly the same counts as num_iter:
+    - lane by lane on a grid of starting points
+    - board by board against julia_board, also for an incomplete batch
+  */
+  SUBCASE("num_iter_lanes matches num_iter") {
+    const double c_real[julia_batch_lanes] = {0.3, -0.8, 0.285, -0.12};
+    const double c_im[julia_batch_lanes] = {-0.45, 0.156, 0.01, 0.75};
+    int iterations[julia_batch_lanes];
+    for (double re = -2.0; re <= 2.0; re += 0.13) {
+      for (double im = -2.0; im <= 2.0; im += 0.17) {
+        const std::complex<double> z0(re, im);
+        num_iter_lanes<julia_batch_lanes>(z0, c_real, c_im, iterations, 500);
+        for (int l = 0; l < julia_batch_lanes; ++l) {
+          CHECK(iterations[l] ==
+                num_iter(z0, std::complex<double>(c_real[l], c_im[l]), 500));
+        }
+      }
+    }
+  }
+
+  SUBCASE("julia_batch_boards matches julia_board") {
+    Julia julia(80);
+    const std::complex<double> cs[3] = {{0.3, -0.45}, {-0.4, 0.6}, {0.0, 0.0}};
+    std::vector<std::vector<double>> boards = julia.julia_batch_boards(cs, 3);
+    REQUIRE(boards.size() == 3);
+    for (int i = 0; i < 3; ++i) {
+      CHECK(boards[i] == julia.julia_board(cs[i]));
+    }
+  }
+}
+
+TEST_CASE("julia sweep reuse of conjugate frames") {
+  /*
+    J(conj(c)) is the mirror image of J(c), the sweep renders only one of the
+    two and mirrors it for the other one, repeated constants are copied
+    - the plan reports which frames are reused
+    - mirrored frames match the direct rendering but for a few pixels lying
+      on the boundary, where the grid is not exactly symmetric
+    - without memory for kept boards every frame is rendered
+  */
+  int dim = 81;
+  const std::vector<std::complex<double>> cs = {
+      {-0.4, 0.6}, {0.285, 0.01}, {-0.4, -0.6}, {-0.4, 0.6}, {0.285, -0.01}};
+
+  SUBCASE("plan") {
+    std::vector<JuliaFrameReport> plan = Julia::plan_julia_sequence(cs, 8);
+    REQUIRE(plan.size() == cs.size());
+    CHECK(plan[0].source == -1);
+    CHECK(plan[1].source == -1);
+    CHECK(plan[2].source == 0);
+    CHECK(plan[2].mirrored);
+    CHECK(plan[3].source == 0);
+    CHECK_FALSE(plan[3].mirrored);
+    CHECK(plan[4].source == 1);
+    CHECK(plan[4].mirrored);
+
+    std::vector<JuliaFrameReport> no_memo = Julia::plan_julia_sequence(cs, 0);
+    for (const JuliaFrameReport &report : no_memo) {
+      CHECK(report.source == -1);
+    }
+  }
+
+  SUBCASE("mirrored frames") {
+    Julia julia(dim);
+    julia.julia_sequence(cs);
+    const std::vector<double> mirrored = julia.getBoard();
+    const std::vector<double> direct = julia.julia_board(cs.back());
+    int different = 0;
+    for (std::size_t i = 0; i < direct.size(); ++i) {
+      different += mirrored[i] != direct[i];
+    }
+    CHECK(different < dim * dim / 100);
+    CHECK(Julia::mirror_board(Julia::mirror_board(direct, dim), dim) ==
+          direct);
+  }
+}
+
+TEST_CASE("julia atlas") {
+  /*
+    the atlas renders a grid of julia thumbnails in a single image:
+    - the image has the size of the grid of thumbnails
+    - every thumbnail is the julia set of its own c
+    - the atlas is written as a ppm of the same size
+  */
+  const int thumbnail_dim = 24;
+  const int columns = 5;
+  const int rows = 3;
+  const std::complex<double> c_min(-1.0, -0.5);
+  const std::complex<double> c_max(0.4, 0.5);
+  Julia thumbnails(thumbnail_dim);
+  std::vector<double> atlas = thumbnails.julia_atlas(
+      c_min, c_max, columns, rows, thumbnail_dim, "test_atlas");
+  const int width = columns * thumbnail_dim;
+  REQUIRE(atlas.size() == width * rows * thumbnail_dim);
+
+  for (int row = 0; row < rows; ++row) {
+    for (int column = 0; column < columns; ++column) {
+      const std::complex<double> c(c_min.real() + column * (1.4 / 4),
+                                   c_min.imag() + row * (1.0 / 2));
+      const std::vector<double> board = thumbnails.julia_board(c);
+      bool same = true;
+      for (int y = 0; y < thumbnail_dim; ++y) {
+        for (int x = 0; x < thumbnail_dim; ++x) {
+          same &= board[y * thumbnail_dim + x] ==
+                  atlas[(row * thumbnail_dim + y) * width +
+                        column * thumbnail_dim + x];
+        }
+      }
+      CHECK(same);
+    }
+  }
+
+  std::ifstream written("./JULIA/test_atlas.ppm");
+  std::string format;
+  int written_width = 0;
+  int written_height = 0;
+  written >> format >> written_width >> written_height;
+  CHECK(format == "P3");
+  CHECK(written_width == width);
+  CHECK(written_height == rows * thumbnail_dim);
+  written.close();
+  std::filesystem::remove("./JULIA/test_atlas.ppm");
+}
+
+TEST_CASE("julia classification") {
+  /*
+    the orbit of the critical point tells if the julia set is connected and
+    whether rendering should look for cycles
+    - known constants get the expected classification
+    - cycle detection never changes the number of iterations
+  */
+  SUBCASE("classify_julia") {
+    JuliaClassification dust = classify_julia({0.3, -0.45});
+    CHECK(dust.kind == JuliaKind::disconnected);
+    CHECK(dust.escape_iteration == 34);
+    CHECK_FALSE(dust.check_periodicity);
+
+    JuliaClassification basilica = classify_julia({-1.0, 0.0});
+    CHECK(basilica.kind == JuliaKind::attracting);
+    CHECK(basilica.period == 2);
+    CHECK(basilica.check_periodicity);
+
+    JuliaClassification rabbit = classify_julia({-0.123, 0.745});
+    CHECK(rabbit.kind == JuliaKind::attracting);
+    CHECK(rabbit.period == 3);
+
+    JuliaClassification parabolic = classify_julia({0.25, 0.0});
+    CHECK(parabolic.kind == JuliaKind::bounded);
+    CHECK_FALSE(parabolic.check_periodicity);
+  }
+
+  SUBCASE("num_iter_periodic matches num_iter") {
+    for (const std::complex<double> c :
+         {std::complex<double>(-1.0, 0.0), std::complex<double>(-0.123, 0.745),
+          std::complex<double>(0.3, -0.3)}) {
+      for (double re = -2.0; re <= 2.0; re += 0.09) {
+        for (double im = -2.0; im <= 2.0; im += 0.11) {
+          const std::complex<double> z0(re, im);
+          CHECK(num_iter_periodic(z0, c, 1000) == num_iter(z0, c, 1000));
+        }
+      }
+    }
+  }
+
+  SUBCASE("the generator reports the classification") {
+    Julia julia(40);
+    const JuliaClassification basilica = julia.julia_generator({-1.0, 0.0});
+    CHECK(basilica.period == 2);
+    // the board of a classification passed in is the one classifying again
+    CHECK(julia.getBoard() == julia.julia_board({-1.0, 0.0}));
+    CHECK(julia.julia_board({-1.0, 0.0}, &basilica) == julia.getBoard());
+    std::vector<JuliaFrameReport> plan = julia.julia_sequence({{0.3, -0.45}});
+    CHECK(plan[0].classification.kind == JuliaKind::disconnected);
+  }
+}
+
+TEST_CASE("perturbation") {
+  /*
+    tests the deep zoom renderer, which iterates every pixel as a difference
+    from a reference orbit:
+    - at shallow zoom it gives the same image as the double precision one
+    - past the resolution of double (scaling factor 1e-14) two different
+      reference points give the same image, while plain double does not
+    - the sequence writes one numbered file per frame
+  */
+  const int dim = 120;
+  Mandelbrot mandelbrot(dim);
+
+  SUBCASE("shallow zoom") {
+    const std::vector<double> board =
+        mandelbrot.mandelbrot_board(0.5, -0.74, 0.1);
+    CHECK(mandelbrot.mandelbrot_deep_board(0.5, -0.74, 0.1,
+                                           board_max_iterations) == board);
+  }
+
+  SUBCASE("beyond double precision") {
+    // c = i is on the boundary and its orbit never escapes
+    const double scaling_factor = 1e-14;
+    const int max_iterations = 1000;
+    const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+    const std::complex<double> corner(-2.0 * scaling_factor,
+                                      -1.13 * scaling_factor);
+    const std::vector<double> board = mandelbrot.mandelbrot_deep_board(
+        scaling_factor, 0.0, 1.0, max_iterations);
+
+    std::vector<double> other_reference(dim * dim);
+    const ReferenceOrbit orbit = compute_reference_orbit(
+        0.0, 1.0, {-0.5 * scaling_factor, 0.3 * scaling_factor},
+        max_iterations);
+    perturbation_rows(other_reference, dim, 0, dim, bounds.real(),
+                      bounds.imag(), corner, orbit, max_iterations);
+
+    std::vector<double> plain(dim * dim);
+    Fractals::fill_board(plain, dim, bounds.real(), bounds.imag(),
+                         corner.real(), 1.0 + corner.imag());
+    const std::vector<double> shallow_board = mandelbrot.mandelbrot_deep_board(
+        scaling_factor, 0.0, 1.0, board_max_iterations);
+
+    int different_references = 0;
+    int different_plain = 0;
+    for (int i = 0; i < dim * dim; ++i) {
+      different_references += board[i] != other_reference[i];
+      different_plain += shallow_board[i] != plain[i];
+    }
+    CHECK(different_references < dim * dim / 100);
+    CHECK(different_plain > dim * dim / 20);
+  }
+
+  SUBCASE("deep sequence") {
+    Mandelbrot small(16);
+    small.mandelbrot_deep_multiple_images(1e-15, 1e-5, 0.0, 1.0, 500);
+    CHECK(std::filesystem::exists(std::filesystem::path("MANDELBROT") /
+                                  "00000_3.000000e-05.ppm"));
+    CHECK(std::filesystem::exists(std::filesystem::path("MANDELBROT") /
+                                  "00003_3.000000e-20.ppm"));
+    CHECK_THROWS_AS(
+        small.mandelbrot_deep_multiple_images(1e-15, 1.0, 0.0, 1.0, 500),
+        std::invalid_argument);
+  }
+}
+
+TEST_CASE("perturbation glitches") {
+  /*
+    pixels whose orbit the reference can not follow are glitched, they are
+    grouped in regions and rendered again with references of their own
+    - glitched_regions groups pixels touching horizontally or vertically
+    - a reference escaping long before most of the frame (c = 0.3) is
+      corrected into the same image as the double precision renderer
+  */
+  SUBCASE("glitched_regions") {
+    const int dim = 5;
+    std::vector<double> glitches(dim * dim, -1.0);
+    // an L shaped region, a single pixel and a diagonal neighbour of it
+    for (const int pixel : {0, 1, 2, 7, 12, 19, 23}) {
+      glitches[pixel] = 0.0;
+    }
+    std::vector<std::vector<int>> regions = glitched_regions(glitches, dim);
+    REQUIRE(regions.size() == 3);
+    CHECK(regions[0].size() == 5);
+    CHECK(regions[1] == std::vector<int>{19});
+    CHECK(regions[2] == std::vector<int>{23});
+  }
+
+  SUBCASE("escaping reference") {
+    const int dim = 60;
+    const double scaling_factor = 1.0;
+    Mandelbrot mandelbrot(dim);
+    const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+    std::vector<double> board(dim * dim);
+    PerturbationStats stats = perturbation_board(
+        board, dim, bounds.real(), bounds.imag(),
+        {-2.0 * scaling_factor, -1.13 * scaling_factor}, 0.3, 0.0,
+        board_max_iterations);
+    CHECK(stats.references > 1);
+    CHECK(stats.glitched_pixels == 0);
+    CHECK(board == mandelbrot.mandelbrot_board(scaling_factor, 0.3, 0.0));
+  }
+}
+
+TEST_CASE("series approximation") {
+  /*
+    the series approximation skips the iterations all the pixels of a deep
+    frame share without changing the image:
+    - inside the period 3 nucleus nearly every iteration is skipped
+    - on the boundary (c = i) some are, and the board is the same as without
+  */
+  const int dim = 60;
+  Mandelbrot mandelbrot(dim);
+  for (const auto &[scaling_factor, center, max_iterations, min_skip] :
+       {std::tuple{1e-10, std::complex<double>(-1.7548776662466927, 0.0), 5000,
+                   4000},
+        std::tuple{1e-14, std::complex<double>(0.0, 1.0), 1000, 10}}) {
+    const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+    const std::complex<double> corner(-2.0 * scaling_factor,
+                                      -1.13 * scaling_factor);
+    std::vector<double> series(dim * dim);
+    std::vector<double> plain(dim * dim);
+    const PerturbationStats stats = perturbation_board(
+        series, dim, bounds.real(), bounds.imag(), corner, center.real(),
+        center.imag(), max_iterations);
+    perturbation_board(plain, dim, bounds.real(), bounds.imag(), corner,
+                       center.real(), center.imag(), max_iterations, false,
+                       false);
+    CHECK(stats.skipped >= min_skip);
+    CHECK(series == plain);
+  }
+}
+
+TEST_CASE("bivariate linear approximation") {
+  /*
+    the linear steps of a reference orbit let the pixels following it jump
+    over many iterations at once:
+    - every level merges pairs of steps of the one below, and a merged step
+      does what its two halves do
+    - inside a minibrot (period 3) the board is the same as with every
+      iteration computed
+  */
+  const double scaling_factor = 1e-12;
+  const std::complex<double> center(-1.7538776662466927, 0.0005);
+  const int max_iterations = 20000;
+
+  SUBCASE("levels") {
+    const ReferenceOrbit orbit =
+        compute_reference_orbit(center.real(), center.imag(), 0.0, 1000);
+    const BlaTable table = bla_table(orbit, scaling_factor);
+    REQUIRE(table.levels[0].size() == orbit.z.size() - 2);
+    for (std::size_t level = 1; level < table.levels.size(); ++level) {
+      CHECK(table.levels[level].size() == table.levels[level - 1].size() / 2);
+    }
+    CHECK(table.levels.back().size() == 1);
+
+    const std::complex<double> dc(scaling_factor, -scaling_factor);
+    std::complex<double> dz = 0.0;
+    for (int n = 0; n < 5; ++n) {
+      dz = 2.0 * orbit.z[n] * dz + dz * dz + dc;
+    }
+    // iteration 5 starts the second step of level 2
+    const BlaStep &step = table.levels[2][1];
+    std::complex<double> iterated = dz;
+    for (int n = 5; n < 9; ++n) {
+      iterated = 2.0 * orbit.z[n] * iterated + iterated * iterated + dc;
+    }
+    CHECK(std::norm(dz) < step.radius2);
+    CHECK(std::abs(step.a * dz + step.b * dc - iterated) <
+          1e-6 * std::abs(iterated));
+  }
+
+  SUBCASE("minibrot") {
+    const int dim = 20;
+    Mandelbrot mandelbrot(dim);
+    const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+    const std::complex<double> corner(-2.0 * scaling_factor,
+                                      -1.13 * scaling_factor);
+    std::vector<double> bla(dim * dim);
+    std::vector<double> plain(dim * dim);
+    perturbation_board(bla, dim, bounds.real(), bounds.imag(), corner,
+                       center.real(), center.imag(), max_iterations, false,
+                       false, true);
+    perturbation_board(plain, dim, bounds.real(), bounds.imag(), corner,
+                       center.real(), center.imag(), max_iterations, false,
+                       false, false);
+    CHECK(bla == plain);
+  }
+}
+
+TEST_CASE("fixed point") {
+  /*
+    tests the fixed point type of the deep reference orbits:
+    - its arithmetic keeps bits far below the ones of double
+    - num_iter_fixed counts the same iterations as num_iter at shallow zoom
+    - at scaling factor 1e-25 two fixed point references give the same
+      image, that num_iter_fixed confirms pixel by pixel, while a long
+      double reference does not
+  */
+  SUBCASE("arithmetic") {
+    const FixedPoint<5> one(1.0);
+    const FixedPoint<5> tiny(std::ldexp(1.0, -100));
+    CHECK(static_cast<double>((one + tiny) - one) == std::ldexp(1.0, -100));
+    CHECK(static_cast<double>((one + tiny).square() - one) ==
+          std::ldexp(1.0, -99));
+    CHECK(static_cast<double>(FixedPoint<5>(1.5) * FixedPoint<5>(-0.25)) ==
+          -0.375);
+    CHECK(static_cast<double>(FixedPoint<5>(-3.0).square()) == 9.0);
+    CHECK(FixedPoint<5>(-0.5) < tiny);
+    CHECK(FixedPoint<5>(-0.5) > FixedPoint<5>(-0.75));
+    CHECK(one - one == FixedPoint<5>());
+    CHECK((-tiny + tiny).is_zero());
+  }
+
+  SUBCASE("num_iter") {
+    for (int i = 0; i < 30; ++i) {
+      for (int j = 0; j < 30; ++j) {
+        const std::complex<double> c(-2.0 + 2.5 * i / 29, -1.2 + 2.4 * j / 29);
+        CHECK(num_iter_fixed(FixedPoint<4>(c.real()), FixedPoint<4>(c.imag()),
+                             board_max_iterations) ==
+              num_iter(0.0, c, board_max_iterations));
+      }
+    }
+  }
+
+  SUBCASE("deep zoom") {
+    const int dim = 40;
+    const double scaling_factor = 1e-25;
+    const int max_iterations = 1000;
+    Mandelbrot mandelbrot(dim);
+    const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+    const std::complex<double> corner(-2.0 * scaling_factor,
+                                      -1.13 * scaling_factor);
+    const std::complex<double> offset(-0.5 * scaling_factor,
+                                      0.3 * scaling_factor);
+    const std::vector<double> board = mandelbrot.mandelbrot_deep_board(
+        scaling_factor, 0.0, 1.0, max_iterations);
+
+    std::vector<double> other_reference(dim * dim);
+    perturbation_rows(other_reference, dim, 0, dim, bounds.real(),
+                      bounds.imag(), corner,
+                      compute_reference_orbit(0.0, 1.0, offset, max_iterations,
+                                              bounds.real()),
+                      max_iterations);
+    std::vector<double> long_double(dim * dim);
+    perturbation_rows(long_double, dim, 0, dim, bounds.real(), bounds.imag(),
+                      corner,
+                      reference_orbit<long double>(0.0, 1.0, offset,
+                                                   max_iterations),
+                      max_iterations);
+    int different_long_double = 0;
+    for (int i = 0; i < dim * dim; ++i) {
+      different_long_double += board[i] != long_double[i];
+    }
+    CHECK(other_reference == board);
+    CHECK(different_long_double > dim * dim / 5);
+
+    for (int pixel = 0; pixel < dim * dim; pixel += 53) {
+      const std::complex<double> dc =
+          pixel_offset(pixel, dim, bounds.real(), bounds.imag(), corner);
+      const FixedPoint<8> c_im = FixedPoint<8>(1.0) + FixedPoint<8>(dc.imag());
+      const int number_iterations =
+          num_iter_fixed(FixedPoint<8>(dc.real()), c_im, max_iterations);
+      CHECK(board[pixel] ==
+            doctest::Approx(1.0 - number_iterations /
+                                      static_cast<double>(max_iterations)));
+    }
+  }
+}
+
+TEST_CASE("double-double") {
+  /*
+    tests the double-double kernel of the mid-depth zooms:
+    - two_prod and the sums keep the bits a double drops
+    - below double_spacing mandelbrot_board matches the perturbation
+      renderer where plain double is pixelated
+    - board_gen renders julia sets with it as well
+  */
+  SUBCASE("arithmetic") {
+    const double tiny = std::ldexp(1.0, -80);
+    CHECK(static_cast<double>((DoubleDouble(1.0) + tiny) - 1.0) == tiny);
+    const double a = 1.0 + std::ldexp(1.0, -30);
+    const DoubleDouble product = two_prod(a, a);
+    CHECK(product.hi == 1.0 + std::ldexp(1.0, -29));
+    CHECK(product.lo == std::ldexp(1.0, -60));
+    CHECK(square(DoubleDouble(a)) == product);
+    CHECK(DoubleDouble(1.0, -tiny) < DoubleDouble(1.0));
+  }
+
+  SUBCASE("mandelbrot") {
+    const int dim = 40;
+    const double scaling_factor = 1e-20;
+    Mandelbrot mandelbrot(dim);
+    const std::vector<double> board =
+        mandelbrot.mandelbrot_board(scaling_factor, 0.0, 1.0);
+    CHECK(board == mandelbrot.mandelbrot_deep_board(scaling_factor, 0.0, 1.0,
+                                                    board_max_iterations));
+
+    const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+    std::vector<double> plain(dim * dim);
+    Fractals::fill_board(plain, dim, bounds.real(), bounds.imag(),
+                         -2.0 * scaling_factor, 1.0 - 1.13 * scaling_factor);
+    CHECK(plain != board);
+  }
+
+  SUBCASE("julia") {
+    const int dim = 60;
+    const std::complex<double> c(-0.8, 0.156);
+    Julia julia(dim);
+    julia.board_gen(4.0 / (dim - 1), 4.0 / (dim - 1), DoubleDouble(-2.0),
+                    DoubleDouble(-2.0), c, false);
+    const std::vector<double> board = julia.julia_board(c);
+    int different = 0;
+    for (int i = 0; i < dim * dim; ++i) {
+      different += julia.getBoard()[i] != board[i];
+    }
+    CHECK(different < dim * dim / 100);
+  }
+}
+
+TEST_CASE("floatexp") {
+  /*
+    tests the extended exponent type and the rescaled perturbation of frames
+    past the range of double:
+    - FloatExp multiplies, adds, compares and prints numbers double can not
+      hold, and keeps infinities and NaN
+    - a frame at 1e-280 gives the same board rendered in double and in units
+      of 2**-1000 through rescaled iterations
+    - at 2**-1100 (about 7e-332) two references give the same board, that
+      num_iter_fixed confirms pixel by pixel
+  */
+  SUBCASE("arithmetic") {
+    const FloatExp tiny(1.0, -2000);
+    CHECK(tiny * FloatExp(1.0, 1000) == FloatExp(1.0, -1000));
+    CHECK(static_cast<double>(tiny * FloatExp(1.0, 1990)) ==
+          std::ldexp(1.0, -10));
+    CHECK(tiny < FloatExp(1.0, -1999));
+    CHECK(-tiny < tiny);
+    CHECK(FloatExp(3.0) * FloatExp(0.5) == FloatExp(1.5));
+    CHECK(scientific(FloatExp(1.0, -1100)) == "7.362152e-332");
+    CHECK(scale_name(FloatExp(3e-5)) == scale_name(3e-5));
+    CHECK(tiny + FloatExp(1.0, -2000) == FloatExp(1.0, -1999));
+    CHECK(FloatExp(3.0) + FloatExp(-1.0) == FloatExp(2.0));
+    CHECK(FloatExp(1.0) + tiny == FloatExp(1.0));
+    CHECK(FloatExp(0.0) + tiny == tiny);
+    CHECK(tiny - tiny == FloatExp(0.0));
+  }
+
+  SUBCASE("infinities and NaN") {
+    // an overflow propagates instead of becoming a large finite number
+    const FloatExp infinite(std::ldexp(1.0, 1000) * std::ldexp(1.0, 1000));
+    CHECK(std::isinf(static_cast<double>(infinite)));
+    CHECK(std::isinf(static_cast<double>(infinite * FloatExp(0.5))));
+    CHECK(std::isinf(static_cast<double>(infinite + FloatExp(1.0, 2000))));
+    CHECK(std::isinf(static_cast<double>(FloatExp(1.0, -2000) - infinite)));
+    CHECK(std::isnan(static_cast<double>(infinite - infinite)));
+    CHECK(std::isnan(static_cast<double>(FloatExp(std::nan("")) + 1.0)));
+    CHECK(scientific(infinite) == "inf");
+  }
+
+  const int dim = 30;
+  const int max_iterations = 1000;
+  Mandelbrot mandelbrot(dim);
+
+  SUBCASE("rescaled iterations") {
+    const double scaling_factor = 1e-280;
+    const double scaled_factor = std::ldexp(scaling_factor, 1000);
+    std::vector<double> boards[2];
+    for (int scaled = 0; scaled < 2; ++scaled) {
+      const double factor = scaled ? scaled_factor : scaling_factor;
+      const std::complex<double> bounds = mandelbrot.boundries(factor);
+      boards[scaled].resize(dim * dim);
+      perturbation_board(boards[scaled], dim, bounds.real(), bounds.imag(),
+                         {-2.0 * factor, -1.13 * factor}, 0.0, 1.0,
+                         max_iterations, false, false, false,
+                         scaled ? -1000 : 0);
+    }
+    CHECK(boards[0] == boards[1]);
+  }
+
+  SUBCASE("beyond double") {
+    const FloatExp scaling_factor(1.0, -1100);
+    const std::vector<double> board = mandelbrot.mandelbrot_deep_board(
+        scaling_factor, 0.0, 1.0, max_iterations);
+    const int scale_exponent = scaling_factor.getExponent();
+    const double scaled_factor = scaling_factor.getMantissa();
+    const std::complex<double> bounds = mandelbrot.boundries(scaled_factor);
+    const std::complex<double> corner(-2.0 * scaled_factor,
+                                      -1.13 * scaled_factor);
+    std::vector<double> other_reference(dim * dim);
+    perturbation_rows(
+        other_reference, dim, 0, dim, bounds.real(), bounds.imag(), corner,
+        compute_reference_orbit(0.0, 1.0,
+                                {-0.5 * scaled_factor, 0.3 * scaled_factor},
+                                max_iterations, bounds.real(), scale_exponent),
+        max_iterations);
+    CHECK(other_reference == board);
+
+    for (int pixel = 0; pixel < dim * dim; pixel += 71) {
+      const std::complex<double> dc =
+          pixel_offset(pixel, dim, bounds.real(), bounds.imag(), corner);
+      const FixedPoint<40> c_im =
+          FixedPoint<40>(1.0) + FixedPoint<40>(dc.imag(), scale_exponent);
+      const int number_iterations = num_iter_fixed(
+          FixedPoint<40>(dc.real(), scale_exponent), c_im, max_iterations);
+      CHECK(board[pixel] ==
+            doctest::Approx(1.0 - number_iterations /
+                                      static_cast<double>(max_iterations)));
+    }
+  }
+}
+
+TEST_CASE("precision ladder") {
+  /*
+    tests the choice of the engine of each frame of a zoom:
+    - the engines go from float to rescaled perturbation as the pixels get
+      closer, float and double-double are skipped for many iterations
+    - the double and double-double engines are the ones of mandelbrot_board,
+      float differs from double only on a few boundary pixels
+    - one deep sequence climbs the whole ladder by itself
+    - the last frame of a zoom to 0 is rendered in double
+  */
+  const int dim = 40;
+  Mandelbrot mandelbrot(dim);
+
+  SUBCASE("choice") {
+    CHECK(mandelbrot.mandelbrot_engine(3.0, 300) == Engine::Float);
+    CHECK(mandelbrot.mandelbrot_engine(3.0, 5000) == Engine::Double);
+    CHECK(mandelbrot.mandelbrot_engine(3.0, 300, Engine::Double) ==
+          Engine::Double);
+    CHECK(mandelbrot.mandelbrot_engine(1e-9, 300) == Engine::Double);
+    CHECK(mandelbrot.mandelbrot_engine(1e-20, 300) == Engine::DoubleDouble);
+    CHECK(mandelbrot.mandelbrot_engine(1e-20, 20000) == Engine::Perturbation);
+    CHECK(mandelbrot.mandelbrot_engine(1e-40, 300) == Engine::Perturbation);
+    CHECK(mandelbrot.mandelbrot_engine(FloatExp(1.0, -1100), 300) ==
+          Engine::PerturbationFloatExp);
+    CHECK(frame_log({7, 1e-20, Engine::DoubleDouble}) ==
+          "frame 00007 1.000000e-20: double-double");
+  }
+
+  SUBCASE("zoom to 0") {
+    // every pixel of a frame of scaling factor 0 is the center
+    CHECK(mandelbrot.mandelbrot_engine(0.0, 300, Engine::Double) ==
+          Engine::Double);
+    CHECK(mandelbrot.mandelbrot_engine(-1.5e-15, 300, Engine::Double) ==
+          Engine::Double);
+    Mandelbrot small(16);
+    const std::vector<FrameRecord> records =
+        small.mandelbrot_multiple_images(0.0, 0.1, -0.74, 0.0);
+    REQUIRE(records.size() == 30);
+    CHECK(static_cast<double>(records.back().scaling_factor) == 0.0);
+    CHECK(records.back().engine == Engine::Double);
+    CHECK(std::filesystem::exists(std::filesystem::path("MANDELBROT") /
+                                  "0.000000.ppm"));
+  }
+
+  SUBCASE("engines") {
+    CHECK(mandelbrot.mandelbrot_engine_board(Engine::Double, 0.5, -0.74, 0.1,
+                                             board_max_iterations) ==
+          mandelbrot.mandelbrot_board(0.5, -0.74, 0.1));
+    CHECK(mandelbrot.mandelbrot_engine_board(Engine::DoubleDouble, 1e-20, 0.0,
+                                             1.0, board_max_iterations) ==
+          mandelbrot.mandelbrot_board(1e-20, 0.0, 1.0));
+
+    const std::vector<double> single = mandelbrot.mandelbrot_engine_board(
+        Engine::Float, 1.0, -0.5, 0.0, board_max_iterations);
+    const std::vector<double> plain = mandelbrot.mandelbrot_board(1.0, -0.5,
+                                                                  0.0);
+    int different = 0;
+    for (int i = 0; i < dim * dim; ++i) {
+      different += single[i] != plain[i];
+    }
+    CHECK(different < dim * dim / 50);
+  }
+
+  SUBCASE("sequence") {
+    Mandelbrot small(16);
+    const std::vector<FrameRecord> records =
+        small.mandelbrot_deep_multiple_images(1e-35, 1e-2, 0.0, 1.0, 500);
+    REQUIRE(records.size() == 18);
+    CHECK(records[0].engine == Engine::Float);
+    CHECK(records[1].engine == Engine::Double);
+    CHECK(records[6].engine == Engine::DoubleDouble);
+    CHECK(records[17].engine == Engine::Perturbation);
+    for (std::size_t frame = 1; frame < records.size(); ++frame) {
+      CHECK(records[frame - 1].engine <= records[frame].engine);
+    }
+  }
+}
+
+TEST_CASE("reference cache") {
+  /*
+    tests the orbit of the zoom center shared by the frames of a zoom:
+    - extending it gives the orbit computed in one go, and the orbits handed
+      out before stay as they were
+    - a deeper frame recomputes it with more bits
+    - frames rendered with it match the ones computing their own orbit
+    - it is read back from disk for the same center only
+  */
+  const int max_iterations = 1000;
+  const double pixel_spacing = 1e-20;
+
+  SUBCASE("extension") {
+    ReferenceCache cache(0.0, 1.0);
+    CHECK(cache.getBits() == -1);
+    const std::shared_ptr<const ReferenceOrbit> short_orbit =
+        cache.orbit(max_iterations / 2, pixel_spacing);
+    const int bits = cache.getBits();
+    CHECK(bits == reference_bits(pixel_spacing, 0));
+    const std::shared_ptr<const ReferenceOrbit> orbit =
+        cache.orbit(max_iterations, pixel_spacing);
+    CHECK(cache.getBits() == bits);
+    CHECK(short_orbit->z.size() == max_iterations / 2 + 1);
+    CHECK(orbit->z == compute_reference_orbit(0.0, 1.0, 0.0, max_iterations,
+                                              pixel_spacing)
+                          .z);
+    CHECK(cache.orbit(max_iterations / 2, pixel_spacing) == orbit);
+
+    CHECK(cache.orbit(max_iterations, 1e-40)->z ==
+          compute_reference_orbit(0.0, 1.0, 0.0, max_iterations, 1e-40).z);
+    CHECK(cache.getBits() > bits);
+    CHECK(cache.orbit(max_iterations, pixel_spacing, -1000)->scale_exponent ==
+          -1000);
+
+    ReferenceCache escaping(1.0, 0.0);
+    CHECK(escaping.orbit(max_iterations, pixel_spacing)->z.size() ==
+          escaping.orbit(2 * max_iterations, pixel_spacing)->z.size());
+  }
+
+  SUBCASE("frames") {
+    const int dim = 30;
+    Mandelbrot mandelbrot(dim);
+    ReferenceCache cache(0.0, 1.0);
+    const std::vector<double> board = mandelbrot.mandelbrot_deep_board(
+        1e-20, 0.0, 1.0, max_iterations, false, &cache);
+    CHECK(board ==
+          mandelbrot.mandelbrot_deep_board(1e-20, 0.0, 1.0, max_iterations));
+    cache.orbit(max_iterations, 1e-40);
+    CHECK(mandelbrot.mandelbrot_deep_board(1e-20, 0.0, 1.0, max_iterations,
+                                           false, &cache) == board);
+  }
+
+  SUBCASE("disk") {
+    const std::string filename =
+        (std::filesystem::temp_directory_path() / "fractals_orbit.bin")
+            .string();
+    std::filesystem::remove(filename);
+    std::shared_ptr<const ReferenceOrbit> orbit;
+    {
+      ReferenceCache cache(0.0, 1.0, filename);
+      orbit = cache.orbit(max_iterations, pixel_spacing);
+    }
+    ReferenceCache loaded(0.0, 1.0, filename);
+    CHECK(loaded.getIterations() == max_iterations);
+    CHECK(loaded.getBits() == reference_bits(pixel_spacing, 0));
+    CHECK(loaded.orbit(max_iterations, pixel_spacing)->z == orbit->z);
+    CHECK(loaded.orbit(2 * max_iterations, pixel_spacing)->z.size() ==
+          2 * max_iterations + 1);
+
+    ReferenceCache other(0.5, 1.0, filename);
+    CHECK(other.getBits() == -1);
+    std::filesystem::remove(filename);
+  }
+}
+
+TEST_CASE("nucleus") {
+  /*
+    tests the nucleus reference of the perturbation frames:
+    - the ball period and Newton's method find the period 3 nucleus in a
+      frame too deep for double, its orbit comes back to 0 and repeats
+    - a frame whose center escapes early needs one reference with it, and
+      gives the same image as without
+  */
+  const int dim = 60;
+  Mandelbrot mandelbrot(dim);
+
+  SUBCASE("finder") {
+    const double scaling_factor = 1e-16;
+    const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+    const std::complex<double> low(-2.0 * scaling_factor,
+                                   -1.13 * scaling_factor);
+    const std::complex<double> high =
+        low + std::complex<double>((dim - 1) * bounds.real(),
+                                   (dim - 1) * bounds.imag());
+    const ReferenceOrbit orbit = nucleus_reference_orbit(
+        -1.7548776662466927, 0.0, low, high, 1000, bounds.real());
+    CHECK(orbit.period == 3);
+    CHECK(orbit.offset.real() > low.real());
+    CHECK(orbit.offset.real() < high.real());
+    CHECK(std::abs(orbit.z[3]) < 1e-30);
+    REQUIRE(orbit.z.size() == 1001);
+    CHECK(orbit.z[1000] == orbit.z[1]);
+  }
+
+  SUBCASE("references") {
+    const double scaling_factor = 0.01;
+    const std::complex<double> center(-1.745, 0.001);
+    const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+    const std::complex<double> corner(-2.0 * scaling_factor,
+                                      -1.13 * scaling_factor);
+    std::vector<double> boards[2];
+    PerturbationStats stats[2];
+    for (int nucleus = 0; nucleus < 2; ++nucleus) {
+      boards[nucleus].resize(dim * dim);
+      stats[nucleus] = perturbation_board(
+          boards[nucleus], dim, bounds.real(), bounds.imag(), corner,
+          center.real(), center.imag(), board_max_iterations, false, true,
+          true, 0, nullptr, nucleus);
+    }
+    CHECK(stats[0].references > 1);
+    CHECK(stats[1].references == 1);
+    const std::vector<double> plain =
+        mandelbrot.mandelbrot_board(scaling_factor, center.real(),
+                                    center.imag());
+    int different = 0;
+    for (int i = 0; i < dim * dim; ++i) {
+      different += boards[1][i] != plain[i];
+    }
+    CHECK(different < dim * dim / 100);
+  }
+}
+
+TEST_CASE("julia zoom") {
+  /*
+    tests the zoomable julia viewport:
+    - the whole frame of scaling factor 1 is the board of julia_board(c)
+    - a frame too deep for double gives the same image with double-double,
+      perturbation and rescaled perturbation
+    - one deep sequence climbs the ladder from double
+  */
+  const int dim = 60;
+  Julia julia(dim);
+  const std::complex<double> c(0.0, 1.0);
+
+  SUBCASE("viewport") {
+    CHECK(julia.julia_board(c, 1.0, 0.0, 0.0) == julia.julia_board(c));
+    CHECK(julia.julia_engine(1.0, 300) == Engine::Double);
+    CHECK(julia.julia_engine(1e-20, 1000) == Engine::DoubleDouble);
+    CHECK(julia.julia_engine(1e-40, 1000) == Engine::Perturbation);
+  }
+
+  SUBCASE("engines") {
+    // i is on the julia set of i: i, -1 + i, -i, -1 + i, ...
+    const double scaling_factor = 1e-20;
+    const std::vector<double> exact = julia.julia_engine_board(
+        Engine::DoubleDouble, c, scaling_factor, 0.0, 1.0, 1000);
+    int distinct = 0;
+    for (int i = 0; i < dim * dim; ++i) {
+      distinct += exact[i] != exact[0];
+    }
+    CHECK(distinct > dim * dim / 4);
+    CHECK(julia.julia_engine_board(Engine::Perturbation, c, scaling_factor,
+                                   0.0, 1.0, 1000) == exact);
+    CHECK(julia.julia_engine_board(Engine::PerturbationFloatExp, c,
+                                   scaling_factor, 0.0, 1.0, 1000) == exact);
+  }
+
+  SUBCASE("sequence") {
+    Julia small(16);
+    const std::vector<FrameRecord> records =
+        small.julia_zoom_multiple_images(c, 1e-35, 1e-2, 0.0, 1.0, 500);
+    REQUIRE(records.size() == 18);
+    CHECK(records[0].engine == Engine::Double);
+    CHECK(records[5].engine == Engine::DoubleDouble);
+    CHECK(records[17].engine == Engine::Perturbation);
+    for (std::size_t frame = 1; frame < records.size(); ++frame) {
+      CHECK(records[frame - 1].engine <= records[frame].engine);
+    }
+    CHECK_THROWS_AS(small.julia_zoom_multiple_images(c, 1e-35, 2.0, 0.0,
+                                                     1.0, 500),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("exponential map") {
+  /*
+    tests the zoom frames resampled from a log-polar strip:
+    - a frame differs from the rendered one only by the interpolation on
+      the boundary, less than by shifting the rendered one a third of a pixel
+    - a long zoom iterates fewer points in its strip than in its frames
+  */
+  const int dim = 60;
+  Mandelbrot mandelbrot(dim);
+  const std::complex<double> center(-0.743643887037151, 0.13182590420533);
+
+  SUBCASE("resampling") {
+    const ExponentialMap map = mandelbrot.mandelbrot_exponential_map(
+        7.0, 1e-5, center.real(), center.imag());
+    CHECK(map.strip.size() ==
+          static_cast<std::size_t>(map.width) * map.rows);
+    for (const double &scaling_factor : {1.0, 0.01}) {
+      const std::vector<double> resampled =
+          mandelbrot.exponential_frame(map, scaling_factor);
+      const std::vector<double> plain = mandelbrot.mandelbrot_board(
+          scaling_factor, center.real(), center.imag());
+      const std::complex<double> bounds =
+          mandelbrot.boundries(scaling_factor);
+      const std::vector<double> shifted = mandelbrot.mandelbrot_board(
+          scaling_factor, center.real() + bounds.real() / 3.0,
+          center.imag() + bounds.imag() / 3.0);
+      double resampling_error = 0.0;
+      double shift_error = 0.0;
+      for (int i = 0; i < dim * dim; ++i) {
+        resampling_error += std::abs(resampled[i] - plain[i]);
+        shift_error += std::abs(shifted[i] - plain[i]);
+      }
+      CHECK(resampling_error < shift_error);
+    }
+  }
+
+  SUBCASE("sequence") {
+    Mandelbrot small(16);
+    const ExponentialMap map = small.mandelbrot_exponential_images(
+        0, 0.02, center.real(), center.imag());
+    CHECK(map.rows > 0);
+    // 150 frames of 16 x 16 pixels
+    CHECK(map.strip.size() < 150 * 16 * 16 / 3);
+    // the strip ends half a pixel into the deepest frame whatever the
+    // rounding of the frames reaching 0: halving the step adds one octave
+    const ExponentialMap fine = small.mandelbrot_exponential_images(
+        0, 0.01, center.real(), center.imag());
+    CHECK(fine.rows - map.rows <= fine.width * std::log(2.0) / (2 * M_PI) + 1);
+  }
+}
+
+TEST_CASE("keyframes") {
+  /*
+    tests the zoom frames downsampled from keyframes:
+    - a keyframe built on the previous one copies a quarter of its samples
+      and is the same as the keyframe rendered from scratch, in double and in
+      double-double
+    - the frames down to half the scaling factor of a keyframe differ from
+      the rendered ones less than shifting those a third of a pixel
+    - a zoom renders one keyframe per halving of the scaling factor
+  */
+  const int dim = 60;
+  Mandelbrot mandelbrot(dim);
+  const std::complex<double> center(-0.743643887037151, 0.13182590420533);
+
+  SUBCASE("reuse") {
+    for (const double &scaling_factor : {0.01, 1e-12}) {
+      const Keyframe previous = mandelbrot.mandelbrot_keyframe(
+          2.0 * scaling_factor, center.real(), center.imag());
+      const Keyframe key = mandelbrot.mandelbrot_keyframe(
+          scaling_factor, center.real(), center.imag(), &previous);
+      const Keyframe fresh = mandelbrot.mandelbrot_keyframe(
+          scaling_factor, center.real(), center.imag());
+      CHECK(key.iterations == fresh.iterations);
+      CHECK(fresh.reused == 0);
+      CHECK(key.reused + key.iterated == key.columns() * key.rows());
+      CHECK(4 * key.reused > key.columns() * key.rows());
+    }
+  }
+
+  SUBCASE("downsampling") {
+    const Keyframe key = mandelbrot.mandelbrot_keyframe(0.02, center.real(),
+                                                        center.imag());
+    for (const double &scaling_factor : {0.02, 0.015, 0.0101}) {
+      const std::vector<double> downsampled =
+          mandelbrot.keyframe_frame(key, scaling_factor);
+      const std::vector<double> plain = mandelbrot.mandelbrot_board(
+          scaling_factor, center.real(), center.imag());
+      const std::complex<double> bounds =
+          mandelbrot.boundries(scaling_factor);
+      const std::vector<double> shifted = mandelbrot.mandelbrot_board(
+          scaling_factor, center.real() + bounds.real() / 3.0,
+          center.imag() + bounds.imag() / 3.0);
+      double downsampling_error = 0.0;
+      double shift_error = 0.0;
+      for (int i = 0; i < dim * dim; ++i) {
+        downsampling_error += std::abs(downsampled[i] - plain[i]);
+        shift_error += std::abs(shifted[i] - plain[i]);
+      }
+      CHECK(downsampling_error < shift_error);
+    }
+  }
+
+  SUBCASE("sequence") {
+    Mandelbrot small(16);
+    // 3 - 0.1 k down to 0.1 and about 0: keyframes 3, 1.5, ..., 0.1875
+    const std::vector<Keyframe> keyframes =
+        small.mandelbrot_keyframe_images(0, 0.1, center.real(),
+                                         center.imag());
+    REQUIRE(keyframes.size() == 5);
+    CHECK(keyframes[0].reused == 0);
+    for (std::size_t k = 1; k < keyframes.size(); ++k) {
+      CHECK(keyframes[k].spacing == 0.5 * keyframes[k - 1].spacing);
+      CHECK(keyframes[k].reused > 0);
+    }
+  }
+
+  SUBCASE("no keyframes past the last frame") {
+    // 3 - 0.01 k reaches 0 exactly, the last frame above it is 0.01: the
+    // keyframes stop at 3 / 256, the first one below 0.02
+    Mandelbrot small(16);
+    const std::vector<Keyframe> keyframes =
+        small.mandelbrot_keyframe_images(0, 0.01, center.real(),
+                                         center.imag());
+    REQUIRE(keyframes.size() == 9);
+    CHECK(keyframes.back().spacing ==
+          0.5 * small.boundries(3.0 / 256).real());
+    const std::vector<double> factors = linear_scaling_factors(0, 0.01);
+    REQUIRE(factors.size() == 300);
+    CHECK(factors[298] == doctest::Approx(0.01));
+    CHECK(factors.back() == 0.0);
+  }
+}
+
+TEST_CASE("camera path") {
+  /*
+    tests the zooms along a camera path:
+    - the scaling factor is interpolated geometrically, also past the range
+      of double, and the center moves as fast as the frame shrinks
+    - the planner climbs the precision ladder and deeper frames cost more
+    - rotated frames are the frames of mandelbrot_board turned around their
+      center
+    - the frames of a path are written with their number and scaling factor
+  */
+  const int dim = 40;
+  Mandelbrot mandelbrot(dim);
+  const std::complex<double> center(-0.743643887037151, 0.13182590420533);
+
+  SUBCASE("interpolation") {
+    const std::vector<CameraKey> path = {{0.0, 1.0, -0.5, 0.0, 0.0},
+                                         {1.0, 1e-6, -0.75, 0.1, 1.0}};
+    const CameraKey middle = camera_at(path, 0.5);
+    CHECK(static_cast<double>(middle.scaling_factor) ==
+          doctest::Approx(1e-3).epsilon(1e-12));
+    // (1 - 1e-3) / (1 - 1e-6) of the way
+    CHECK(middle.center_real ==
+          doctest::Approx(-0.5 - 0.25 * 0.999 / 0.999999));
+    CHECK(middle.rotation == doctest::Approx(0.5));
+    CHECK(camera_at(path, -1.0).center_real == -0.5);
+    CHECK(camera_at(path, 2.0).scaling_factor == path.back().scaling_factor);
+
+    const std::vector<CameraKey> deep = {
+        {0.0, 1.0, 0.0, 1.0}, {2.0, FloatExp(1.0, -2000), 0.0, 1.0}};
+    // 2**-1000, out of the range of double
+    CHECK(camera_at(deep, 1.0).scaling_factor.log10() ==
+          doctest::Approx(-1000.0 * std::log10(2.0)));
+  }
+
+  SUBCASE("plan") {
+    const std::vector<CameraKey> path = {
+        {0.0, 3.0, -0.75, 0.1}, {1.0, 1e-20, center.real(), center.imag()}};
+    const std::vector<CameraFrame> plans =
+        mandelbrot.mandelbrot_camera_plan(path, 6, 500);
+    REQUIRE(plans.size() == 6);
+    CHECK(plans.front().engine == Engine::Float);
+    CHECK(plans.back().engine == Engine::DoubleDouble);
+    for (std::size_t frame = 1; frame < plans.size(); ++frame) {
+      CHECK(plans[frame - 1].engine <= plans[frame].engine);
+      CHECK(plans[frame - 1].cost <= plans[frame].cost);
+    }
+  }
+
+  SUBCASE("rotation") {
+    const double pi = std::acos(-1.0);
+    // a frame in double and one in double-double, on the boundary
+    const std::pair<double, std::complex<double>> frames[2] = {
+        {0.5, center}, {1e-20, std::complex<double>(0.0, 1.0)}};
+    for (const auto &[scaling_factor, middle] : frames) {
+      const bool double_double = scaling_factor < 1e-10;
+      const std::vector<double> plain = mandelbrot.mandelbrot_board(
+          scaling_factor, middle.real(), middle.imag());
+      for (const double &rotation : {0.0, 2.0 * pi}) {
+        const std::vector<double> rotated =
+            mandelbrot.mandelbrot_rotated_board(scaling_factor, middle.real(),
+                                                middle.imag(), rotation, 300,
+                                                double_double);
+        int different = 0;
+        for (int i = 0; i < dim * dim; ++i) {
+          different += rotated[i] != plain[i];
+        }
+        CHECK(different < dim * dim / 50);
+      }
+      const std::vector<double> turned = mandelbrot.mandelbrot_rotated_board(
+          scaling_factor, middle.real(), middle.imag(), 0.5 * pi, 300,
+          double_double);
+      CHECK(turned != plain);
+    }
+  }
+
+  SUBCASE("images") {
+    Mandelbrot small(16);
+    const std::vector<CameraKey> path = {
+        {0.0, 3.0, -0.5, 0.0}, {1.0, 1e-3, center.real(), center.imag(), 1.0}};
+    const std::vector<CameraFrame> plans =
+        small.mandelbrot_camera_images(path, 4, 300);
+    REQUIRE(plans.size() == 4);
+    for (const CameraFrame &plan : plans) {
+      CHECK(std::filesystem::exists(
+          std::filesystem::path("MANDELBROT") /
+          (sequence_name(plan.frame, plan.camera.scaling_factor) + ".ppm")));
+    }
+    CHECK(small.getBoard() == small.mandelbrot_camera_board(plans.back(), 300));
+  }
+}
+
+TEST_CASE("pan") {
+  /*
+    tests the pans of a board:
+    - a pan renders only the strips it exposes, and panning back gives the
+      same board as before
+    - a panned board is the board of the panned frame
+    - boards not rendered in double are not panned
+  */
+  const int dim = 60;
+
+  SUBCASE("strips") {
+    Mandelbrot mandelbrot(dim);
+    mandelbrot.mandelbrot_generator(1.0, -0.5, 0.0);
+    const std::vector<double> before = mandelbrot.getBoard();
+    CHECK(mandelbrot.pan(5, -3) == 5 * dim + 3 * (dim - 5));
+    CHECK(mandelbrot.getViewport().pan_x == 5);
+    CHECK(mandelbrot.pan(-5, 3) == 5 * dim + 3 * (dim - 5));
+    CHECK(mandelbrot.getBoard() == before);
+    CHECK(mandelbrot.pan(2 * dim, 0) == dim * dim);
+    CHECK(mandelbrot.pan(-2 * dim, 0) == dim * dim);
+    CHECK(mandelbrot.getBoard() == before);
+  }
+
+  SUBCASE("frames") {
+    Julia julia(dim);
+    const std::complex<double> c(-0.8, 0.156);
+    julia.julia_generator(c);
+    julia.pan(-7, 11);
+    // pixel (x, y) is now at (x - 7, y + 11) 4 / (dim - 1) - 2 (1 + i)
+    std::vector<double> expected(dim * dim);
+    Viewport frame = julia.getViewport();
+    Fractals::fill_rectangle(expected, dim, frame, 0, dim, 0, dim);
+    CHECK(julia.getBoard() == expected);
+    frame.pan_x = 0;
+    frame.pan_y = 0;
+    frame.corner_real += -7 * frame.z_real_bound;
+    frame.corner_im += 11 * frame.z_im_bound;
+    Fractals::fill_rectangle(expected, dim, frame, 0, dim, 0, dim);
+    int different = 0;
+    for (int i = 0; i < dim * dim; ++i) {
+      different += julia.getBoard()[i] != expected[i];
+    }
+    CHECK(different < dim * dim / 100);
+  }
+
+  SUBCASE("no viewport") {
+    Mandelbrot mandelbrot(dim);
+    mandelbrot.mandelbrot_generator(1e-20, 0.0, 1.0);
+    const std::vector<double> before = mandelbrot.getBoard();
+    CHECK(mandelbrot.pan(1, 1) == 0);
+    CHECK(mandelbrot.getBoard() == before);
+  }
+}
+
+TEST_CASE("progressive rendering") {
+  /*
+    tests the progressive renderer:
+    - without a deadline every pass is done and the board is the one of
+      board_gen, with its viewport
+    - a deadline already passed leaves the complete board of the first pass,
+      a block of one color per first pixel
+    - a cancellation stops the render after the pass that raised it, whose
+      board is already complete
+    - the render returns right after its deadline, whatever the pass
+  */
+  const int dim = 50;
+  Mandelbrot mandelbrot(dim);
+  const std::complex<double> bounds = mandelbrot.boundries(1.0);
+  const double corner_real = -0.5 - 2.0;
+  const double corner_im = -1.13;
+  const auto later = std::chrono::steady_clock::now() + std::chrono::hours(1);
+
+  SUBCASE("complete") {
+    std::vector<int> blocks;
+    const ProgressivePass progress = mandelbrot.progressive_gen(
+        bounds.real(), bounds.imag(), corner_real, corner_im, 0.0, true, later,
+        nullptr, [&](const ProgressivePass &pass) {
+          blocks.push_back(pass.block);
+        });
+    CHECK(blocks == std::vector<int>{16, 8, 4, 2, 1});
+    CHECK(progress.block == 1);
+    CHECK(!progress.interrupted);
+    CHECK(progress.rendered == dim * dim);
+    CHECK(mandelbrot.getViewport().valid);
+    const std::vector<double> progressive = mandelbrot.getBoard();
+    mandelbrot.board_gen(bounds.real(), bounds.imag(), corner_real,
+                         corner_im);
+    CHECK(progressive == mandelbrot.getBoard());
+  }
+
+  SUBCASE("deadline") {
+    const ProgressivePass progress = mandelbrot.progressive_gen(
+        bounds.real(), bounds.imag(), corner_real, corner_im, 0.0, true,
+        std::chrono::steady_clock::now());
+    CHECK(progress.block == 16);
+    CHECK(progress.interrupted);
+    // ceil(50 / 16) blocks a side
+    CHECK(progress.rendered == 4 * 4);
+    CHECK(!mandelbrot.getViewport().valid);
+    const std::vector<double> &board = mandelbrot.getBoard();
+    for (int y = 0; y < dim; ++y) {
+      for (int x = 0; x < dim; ++x) {
+        CHECK(board[y * dim + x] == board[(y / 16) * 16 * dim + x / 16 * 16]);
+      }
+    }
+  }
+
+  SUBCASE("cancel") {
+    std::atomic<bool> cancel = false;
+    const ProgressivePass progress = mandelbrot.progressive_gen(
+        bounds.real(), bounds.imag(), corner_real, corner_im, 0.0, true, later,
+        &cancel, [&](const ProgressivePass &pass) {
+          cancel = pass.block <= 4;
+        });
+    CHECK(progress.block == 4);
+    CHECK(progress.interrupted);
+  }
+
+  SUBCASE("returns on time") {
+    // a board taking longer than the budget; how late the render may return
+    // is measured against the time of the whole board on the same machine,
+    // so that a loaded machine or a sanitizer slows both
+    Mandelbrot large(600);
+    const std::complex<double> large_bounds = large.boundries(1.0);
+    const auto whole_start = std::chrono::steady_clock::now();
+    large.board_gen(large_bounds.real(), large_bounds.imag(), corner_real,
+                    corner_im);
+    const auto whole = std::chrono::steady_clock::now() - whole_start;
+    const auto budget = whole / 4;
+    const auto start = std::chrono::steady_clock::now();
+    const ProgressivePass progress = large.progressive_gen(
+        large_bounds.real(), large_bounds.imag(), corner_real, corner_im, 0.0,
+        true, start + budget);
+    const auto late = std::chrono::steady_clock::now() - (start + budget);
+    CHECK(progress.interrupted);
+    // the first pass is always complete
+    CHECK(progress.block <= 16);
+    CHECK(progress.rendered >= 38 * 38);
+    CHECK(late < whole / 4);
+  }
+}
+
+#if defined(__cpp_impl_coroutine)
+RenderTask<double> mean_color(RenderTask<std::vector<double>> frame) {
+  // coroutine waiting for a render, for the async render test case
+  const std::vector<double> board = co_await frame;
+  double total = 0.0;
+  for (const double &color : board) {
+    total += color;
+  }
+  co_return total / board.size();
+}
+
+TEST_CASE("async render") {
+  /*
+    tests the asynchronous renders:
+    - their boards are the ones of mandelbrot_board and julia_board, in
+      double and in double-double
+    - a coroutine awaits a render and resumes with its board
+    - a render cancelled before its tiles start throws RenderCancelled, and
+      cancelling or dropping a coroutine cancels the render it awaits
+    - a render in double-double is cancelled like one in double, and a
+      tile cancelling its own render stops the tiles not started
+    - every coroutine awaiting a render resumes
+  */
+  const int dim = 70;
+  Mandelbrot mandelbrot(dim);
+  Julia julia(dim);
+
+  // keeps every worker of the pool busy until released, so that the tiles
+  // queued meanwhile have not started when the test cancels them
+  std::promise<void> release;
+  auto block_pool = [&] {
+    std::shared_future<void> gate = release.get_future().share();
+    for (unsigned int w = 0; w < shared_pool().size(); ++w) {
+      shared_pool().submit([gate] { gate.wait(); });
+    }
+  };
+
+  SUBCASE("boards") {
+    CHECK(mandelbrot_async(mandelbrot, 1.0, -0.5, 0.0, 16).get() ==
+          mandelbrot.mandelbrot_board(1.0, -0.5, 0.0));
+    CHECK(mandelbrot_async(mandelbrot, 1e-20, 0.0, 1.0).get() ==
+          mandelbrot.mandelbrot_board(1e-20, 0.0, 1.0));
+    const std::complex<double> c(-0.8, 0.156);
+    CHECK(julia_async(julia, c).get() == julia.julia_board(c));
+  }
+
+  SUBCASE("coroutine") {
+    const std::vector<double> board =
+        mandelbrot.mandelbrot_board(1.0, -0.5, 0.0);
+    double total = 0.0;
+    for (const double &color : board) {
+      total += color;
+    }
+    const RenderTask<double> mean =
+        mean_color(mandelbrot_async(mandelbrot, 1.0, -0.5, 0.0));
+    CHECK(mean.get() == total / board.size());
+    CHECK(mean.done());
+  }
+
+  SUBCASE("cancel") {
+    block_pool();
+    const RenderTask<std::vector<double>> task =
+        mandelbrot_async(mandelbrot, 1.0, -0.5, 0.0);
+    task.cancel();
+    release.set_value();
+    CHECK_THROWS_AS(task.get(), RenderCancelled);
+  }
+
+  SUBCASE("abandon") {
+    block_pool();
+    const RenderTask<std::vector<double>> frame =
+        mandelbrot_async(mandelbrot, 1.0, -0.5, 0.0);
+    std::stop_token dropped;
+    {
+      const RenderTask<std::vector<double>> alone =
+          mandelbrot_async(mandelbrot, 0.5, -0.5, 0.0);
+      dropped = alone.token();
+    }
+    CHECK(dropped.stop_requested());
+    const RenderTask<double> mean = mean_color(frame);
+    CHECK(!frame.token().stop_requested());
+    mean.cancel();
+    CHECK(frame.token().stop_requested());
+    release.set_value();
+    CHECK_THROWS_AS(mean.get(), RenderCancelled);
+  }
+
+  SUBCASE("cancel a double-double render") {
+    block_pool();
+    const Mandelbrot &frozen = mandelbrot;
+    const RenderTask<std::vector<double>> task =
+        mandelbrot_async(frozen, 1e-20, 0.0, 1.0);
+    task.cancel();
+    release.set_value();
+    CHECK_THROWS_AS(task.get(), RenderCancelled);
+  }
+
+  SUBCASE("cancel from a tile") {
+    // pixel tiles in double-double, the first of them cancelling the render:
+    // only the tiles already started by the other workers are filled
+    block_pool();
+    const std::complex<double> bounds = mandelbrot.boundries(1e-20);
+    const DoubleDouble corner_real = two_sum(0.0, -2.0 * 1e-20);
+    const DoubleDouble corner_im = two_sum(1.0, -1.13 * 1e-20);
+    const RenderTask<std::vector<double>> *running = nullptr;
+    std::atomic<int> filled(0);
+    const RenderTask<std::vector<double>> task = render_tiles_async(
+        dim, 1,
+        [&](std::vector<double> &board, const int &x_first, const int &x_last,
+            const int &y_first, const int &y_last) {
+          if (filled.fetch_add(1) == 0) {
+            running->cancel();
+          }
+          Fractals::fill_rectangle(board, dim, bounds.real(), bounds.imag(),
+                                   corner_real, corner_im, 0.0, true,
+                                   board_max_iterations, x_first, x_last,
+                                   y_first, y_last);
+        });
+    running = &task;
+    release.set_value();
+    CHECK_THROWS_AS(task.get(), RenderCancelled);
+    CHECK(filled <= static_cast<int>(shared_pool().size()));
+  }
+
+  SUBCASE("several coroutines") {
+    block_pool();
+    const RenderTask<std::vector<double>> frame =
+        mandelbrot_async(mandelbrot, 1.0, -0.5, 0.0);
+    const RenderTask<double> first = mean_color(frame);
+    const RenderTask<double> second = mean_color(frame);
+    release.set_value();
+    CHECK(first.get() == second.get());
+    CHECK(second.done());
+  }
+}
+#endif
+
+TEST_CASE("lazy frame") {
+  /*
+    tests the frames rendered when read:
+    - a crop renders only the tiles it touches, and is the crop of the
+      rendered board
+    - reading the whole frame from many threads at once gives the board of
+      mandelbrot_board, rendering each tile once
+    - julia frames are the boards of julia_board
+    - frames can be kept in containers, and deep frames are refused
+  */
+  const int dim = 100;
+  Mandelbrot mandelbrot(dim);
+  const std::vector<double> plain = mandelbrot.mandelbrot_board(1.0, -0.5, 0.0);
+
+  SUBCASE("region") {
+    LazyFrame frame = mandelbrot.mandelbrot_lazy_frame(1.0, -0.5, 0.0, 25);
+    CHECK(frame.getTiles() == 16);
+    CHECK(frame.getRenderedTiles() == 0);
+    const std::vector<double> crop = frame.region(30, 10, 15, 20);
+    // columns 30 to 44 and rows 10 to 29: tiles (1, 0) and (1, 1)
+    CHECK(frame.getRenderedTiles() == 2);
+    for (int y = 0; y < 20; ++y) {
+      for (int x = 0; x < 15; ++x) {
+        CHECK(crop[y * 15 + x] == plain[(y + 10) * dim + x + 30]);
+      }
+    }
+    CHECK(frame.at(99, 99) == plain.back());
+    CHECK(frame.getRenderedTiles() == 3);
+  }
+
+  SUBCASE("threads") {
+    LazyFrame frame = mandelbrot.mandelbrot_lazy_frame(1.0, -0.5, 0.0);
+    std::vector<double> read(dim * dim);
+    parallel_jobs(dim * dim, [&](const int &pixel) {
+      read[pixel] = frame.at(pixel % dim, pixel / dim);
+    });
+    CHECK(read == plain);
+    CHECK(frame.getRenderedTiles() == frame.getTiles());
+    CHECK(frame.getBoard() == plain);
+  }
+
+  SUBCASE("julia") {
+    Julia julia(dim);
+    const std::complex<double> c(-0.8, 0.156);
+    LazyFrame frame = julia.julia_lazy_frame(c);
+    CHECK(frame.getBoard(true) == julia.julia_board(c));
+  }
+
+  SUBCASE("containers") {
+    std::vector<LazyFrame> frames;
+    for (const double &scaling_factor : {1.0, 0.5}) {
+      frames.push_back(
+          mandelbrot.mandelbrot_lazy_frame(scaling_factor, -0.5, 0.0));
+    }
+    frames.front().at(0, 0);
+    LazyFrame moved = std::move(frames.front());
+    CHECK(moved.getRenderedTiles() == 1);
+    CHECK(moved.getBoard() == plain);
+    CHECK(frames.back().getBoard() ==
+          mandelbrot.mandelbrot_board(0.5, -0.5, 0.0));
+    CHECK_THROWS_AS(mandelbrot.mandelbrot_lazy_frame(1e-20, 0.0, 1.0),
+                    std::invalid_argument);
+  }
+
+  SUBCASE("out of the frame") {
+    LazyFrame frame = mandelbrot.mandelbrot_lazy_frame(1.0, -0.5, 0.0);
+    const int dim = frame.getDimension();
+    CHECK_THROWS_AS(frame.at(-1, 0), std::out_of_range);
+    CHECK_THROWS_AS(frame.at(0, dim), std::out_of_range);
+    CHECK_THROWS_AS(frame.region(dim - 4, 0, 5, 1), std::out_of_range);
+    CHECK_THROWS_AS(frame.region(0, -1, 1, 1), std::out_of_range);
+    CHECK_THROWS_AS(frame.region(0, 0, -1, 1), std::out_of_range);
+    CHECK(frame.region(dim, dim, 0, 0).empty());
+    CHECK(frame.getRenderedTiles() == 0);
+    CHECK(frame.region(dim - 4, dim - 1, 4, 1).size() == 4);
+  }
+}
+
+TEST_CASE("batch points") {
+  /*
+    tests the escape times of scattered points against num_iter:
+    - mandelbrot and julia points, some of them padding the last lanes
+    - cycle detection and the cardioid shortcut change no count
+    - the serial batches give the same counts
+  */
+  const std::size_t count = 10003;
+  std::vector<double> real(count);
+  std::vector<double> im(count);
+  for (std::size_t k = 0; k < count; ++k) {
+    // scattered over the frame, no two points close in the arrays
+    real[k] = -2.1 + 2.7 * std::fmod(k * 0.6180339887, 1.0);
+    im[k] = -1.2 + 2.4 * std::fmod(k * 0.7548776662, 1.0);
+  }
+  const int max_iter = 300;
+  std::vector<int> expected(count);
+  for (std::size_t k = 0; k < count; ++k) {
+    expected[k] = num_iter(0.0, {real[k], im[k]}, max_iter);
+  }
+
+  SUBCASE("mandelbrot") {
+    std::vector<int> iterations(count, -1);
+    batch_num_iter(real.data(), im.data(), iterations.data(), count, max_iter);
+    CHECK(iterations == expected);
+    PointQuery query;
+    query.check_period = true;
+    query.skip_cardioid = true;
+    std::vector<int> shortcuts(count, -1);
+    batch_num_iter(real.data(), im.data(), shortcuts.data(), count, max_iter,
+                   query);
+    CHECK(shortcuts == expected);
+    query.parallel = false;
+    std::vector<int> serial(count, -1);
+    batch_num_iter(real.data(), im.data(), serial.data(), count, max_iter,
+                   query);
+    CHECK(serial == expected);
+    CHECK(in_cardioid_or_bulb(0.0, 0.0));
+    CHECK(in_cardioid_or_bulb(-1.0, 0.1));
+    CHECK_FALSE(in_cardioid_or_bulb(0.3, 0.0));
+    CHECK_FALSE(in_cardioid_or_bulb(-0.75, 0.2));
+  }
+
+  SUBCASE("julia") {
+    const std::complex<double> c(-0.8, 0.156);
+    std::vector<int> iterations(count, -1);
+    PointQuery query;
+    query.c = c;
+    query.mandel_or_julia = false;
+    query.check_period = true;
+    batch_num_iter(real.data(), im.data(), iterations.data(), count, max_iter,
+                   query);
+    for (std::size_t k = 0; k < count; ++k) {
+      expected[k] = num_iter({real[k], im[k]}, c, max_iter);
+    }
+    CHECK(iterations == expected);
+  }
+}
+
+TEST_CASE("mandelbrot area") {
+  /*
+    tests the Monte Carlo area estimates:
+    - rectangles wholly inside or outside the set
+    - the histogram counts every sample
+    - the parallel estimate is the serial one
+    - estimates with different seeds agree within their intervals
+  */
+  const AreaEstimate cardioid =
+      mandelbrot_area(-0.5, -0.1, -0.2, 0.2, 10000, 100);
+  CHECK(cardioid.samples == 10000);
+  CHECK(cardioid.area == doctest::Approx(0.16));
+  CHECK(cardioid.standard_error == doctest::Approx(0.0));
+  CHECK(cardioid.inside_fraction() == 1.0);
+
+  const AreaEstimate outside = mandelbrot_area(2.5, 3.0, 0.0, 1.0, 1000, 100);
+  CHECK(outside.area == 0.0);
+  CHECK(outside.histogram[1] == outside.samples);
+
+  // the upper half, 100003 samples rounded up to 16 replicates of 6251
+  const AreaEstimate serial =
+      mandelbrot_area(-2.0, 0.5, 0.0, 1.25, 100003, 200, 1);
+  CHECK(serial.samples == 16 * 6251);
+  std::uint64_t total = 0;
+  for (const std::uint64_t &count : serial.histogram) {
+    total += count;
+  }
+  CHECK(total == serial.samples);
+  CHECK(serial.low < serial.area);
+  CHECK(serial.area < serial.high);
+  CHECK(serial.samples_per_second > 0.0);
+
+  const AreaEstimate parallel =
+      mandelbrot_area(-2.0, 0.5, 0.0, 1.25, 100003, 200, 1, 16, true);
+  CHECK(parallel.area == serial.area);
+  CHECK(parallel.standard_error == serial.standard_error);
+  CHECK(parallel.histogram == serial.histogram);
+
+  const AreaEstimate other =
+      mandelbrot_area(-2.0, 0.5, 0.0, 1.25, 100003, 200, 2);
+  CHECK(other.area != serial.area);
+  CHECK(std::abs(other.area - serial.area) <
+        3.0 * (other.standard_error + serial.standard_error));
+}
+
+TEST_CASE("bivariate linear approximation benchmark" * doctest::skip()) {
+  /*
+    times a 1e6 iterations frame inside a minibrot with every iteration
+    computed, with the linear steps, and with the series approximation,
+    run it with --no-skip
+  */
+  const int dim = 24;
+  const double scaling_factor = 1e-12;
+  const int max_iterations = 1000000;
+  Mandelbrot mandelbrot(dim);
+  const std::complex<double> bounds = mandelbrot.boundries(scaling_factor);
+  for (const auto &[use_series, use_bla] :
+       {std::pair{false, false}, std::pair{false, true},
+        std::pair{true, false}}) {
+    std::vector<double> board(dim * dim);
+    const auto start = std::chrono::steady_clock::now();
+    perturbation_board(board, dim, bounds.real(), bounds.imag(),
+                       {-2.0 * scaling_factor, -1.13 * scaling_factor},
+                       -1.7538776662466927, 0.0005, max_iterations, false,
+                       use_series, use_bla);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    MESSAGE("series " << use_series << ", linear steps " << use_bla << ": "
+                      << elapsed.count() << " s");
+  }
+}
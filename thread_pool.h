@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+  // fixed number of worker threads consuming a shared queue of tasks
+private:
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable wake_up;
+  bool stopping = false;
+
+public:
+  ThreadPool(unsigned int num_threads) {
+    for (unsigned int i = 0; i < num_threads; ++i) {
+      workers.emplace_back([this] {
+        while (true) {
+          std::function<void()> task;
+          {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake_up.wait(lock, [this] {
+              return this->stopping || !this->tasks.empty();
+            });
+            if (this->stopping && this->tasks.empty()) {
+              return;
+            }
+            task = std::move(this->tasks.front());
+            this->tasks.pop();
+          }
+          task();
+        }
+      });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake_up.notify_all();
+    for (std::thread &worker : workers) {
+      worker.join();
+    }
+  }
+
+  unsigned int size() const { return workers.size(); }
+
+  template <typename Task>
+  auto submit(Task task) -> std::future<decltype(task())> {
+    /*
+      queues a task on the pool
+      task: callable without arguments
+
+      returns a future holding the value returned by the task (or the exception
+      it threw)
+    */
+    using Result = decltype(task());
+    auto packaged =
+        std::make_shared<std::packaged_task<Result()>>(std::move(task));
+    std::future<Result> result = packaged->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.emplace([packaged] { (*packaged)(); });
+    }
+    wake_up.notify_one();
+    return result;
+  }
+};
+
+ThreadPool &shared_pool() {
+  /*
+    pool shared by all the renderers, one worker per hardware thread
+  */
+  static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+int jobs_in_flight(const std::size_t &memory_budget,
+                   const std::size_t &bytes_per_job) {
+  /*
+    number of jobs a sequence renderer may keep in flight
+    memory_budget: bytes available for boards rendered but not yet consumed
+    bytes_per_job: bytes of board data produced by a single job
+
+    never less than one job, never more than twice the workers of the pool
+  */
+  const std::size_t by_memory =
+      memory_budget / std::max<std::size_t>(1, bytes_per_job);
+  const std::size_t by_workers = 2 * shared_pool().size();
+  return static_cast<int>(
+      std::max<std::size_t>(1, std::min(by_memory, by_workers)));
+}
+
+template <typename Job, typename Consume>
+void ordered_parallel_jobs(const int &num_jobs, const int &max_in_flight,
+                           Job job, Consume consume) {
+  /*
+    runs job(0) ... job(num_jobs - 1) on the shared pool and hands their results
+    to consume in index order on the calling thread
+    max_in_flight: results alive at the same time (running or waiting to be
+    consumed), it is what bounds the memory used by a sweep
+  */
+  using Result = decltype(job(0));
+  std::deque<std::future<Result>> in_flight;
+  int next = 0;
+  try {
+    for (int done = 0; done < num_jobs; ++done) {
+      while (next < num_jobs &&
+             static_cast<int>(in_flight.size()) < max_in_flight) {
+        in_flight.push_back(
+            shared_pool().submit([job, next] { return job(next); }));
+        ++next;
+      }
+      Result result = in_flight.front().get();
+      in_flight.pop_front();
+      consume(done, std::move(result));
+    }
+  } catch (...) {
+    // the jobs may refer to the caller's variables, all of them must be over
+    // before rethrowing
+    for (std::future<Result> &job_left : in_flight) {
+      job_left.wait();
+    }
+    throw;
+  }
+}
+
+template <typename Job>
+void parallel_jobs(const int &num_jobs, Job job) {
+  /*
+    runs job(0) ... job(num_jobs - 1) on the shared pool and waits for all of
+    them, the jobs are grouped in a few chunks per worker so that scheduling
+    costs do not depend on the number of jobs
+    must not be called from a job running on the pool
+  */
+  const int num_chunks =
+      std::min<int>(num_jobs, 4 * static_cast<int>(shared_pool().size()));
+  std::vector<std::future<void>> chunks;
+  for (int chunk = 0; chunk < num_chunks; ++chunk) {
+    const int first = static_cast<long>(num_jobs) * chunk / num_chunks;
+    const int last = static_cast<long>(num_jobs) * (chunk + 1) / num_chunks;
+    chunks.push_back(shared_pool().submit([&job, first, last] {
+      for (int i = first; i < last; ++i) {
+        job(i);
+      }
+    }));
+  }
+  // every chunk refers to job, all of them must be over before rethrowing
+  for (std::future<void> &chunk : chunks) {
+    chunk.wait();
+  }
+  for (std::future<void> &chunk : chunks) {
+    chunk.get();
+  }
+}